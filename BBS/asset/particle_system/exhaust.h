@@ -35,6 +35,9 @@ namespace bb
 	call update(dt) of 'exhaust' from Update() and call window.draw(exhaust) from
 	Render() of game loop to display the effect.
 
+	with lots of particles, call update(dt, MY_GAME.jobs()) instead, to update them in
+	parallel on all the cpu cores.
+
 	you can also delete all the particles with exhaust.clear()
 */
 
@@ -112,48 +115,65 @@ public:
 
 	void update(double dt)
 	{
-		for (size_t i = 0; i < m_ecs.entity_count();)
+		m_ecs.each<VERTEX, DALPHA, ALPHA, VELOCITY>([&](size_t id, sf::Vertex &particle, double &dalpha, double &alpha, sf::Vector2f &velocity)
 		{
-			auto& entity = m_ecs.entity(i);
-
-			auto& alpha = entity.get<ALPHA>();
+			// calculating next possible value of alpha of the particle
 
-			// calculating next possible value of alpha of ith particle
-
-			alpha -= entity.get<DALPHA>() * dt;
+			alpha -= dalpha * dt;
 
 			if (alpha <= 0)
 			{
 				/*
-					if alpha of a point <= 0 the point is not visible so we "delete" it by,
-					replacing the point with last point and then deleting the last point
+					if alpha of a point <= 0 the point is not visible so we "delete" it, the kill is
+					recorded and done after all the particles are updated
 				*/
 
-				m_ecs.kill_entity(entity);
+				m_commands.kill(m_ecs.handle(id));
 
-				// now go to the top of this iteration to update this new particle's alpha
+				return;
+			}
 
-				// if the deleted particle was the last particle the loop condition will stop the loop
+			// updating alpha of the particle
 
-				continue;
-			}
+			particle.color.a = static_cast<uint8_t>(alpha);
 
-			auto& particle = entity.get<VERTEX>();
+			// updating position based on velociity
+
+			particle.position.x += static_cast<float>(velocity.x * dt);
+
+			particle.position.y += static_cast<float>(velocity.y * dt);
+		});
+
+		m_commands.flush(m_ecs);
+	}
 
-			// updating alpha of ith particle
+	// same as update(dt), but the particles are updated in parallel on the thread pool
+
+	void update(double dt, JOB_SYSTEM &jobs)
+	{
+		m_ecs.parallel_each<VERTEX, DALPHA, ALPHA, VELOCITY>(jobs, [dt](sf::Vertex &particle, double &dalpha, double &alpha, sf::Vector2f &velocity)
+		{
+			// calculating next possible value of alpha of the particle
+
+			alpha -= dalpha * dt;
+
+			if (alpha <= 0)
+			{
+				return true;	// not visible, kill it (after all the particles are updated)
+			}
+
+			// updating alpha of the particle
 
 			particle.color.a = static_cast<uint8_t>(alpha);
 
 			// updating position based on velociity
 
-			auto& velocity = entity.get<VELOCITY>();
-
 			particle.position.x += static_cast<float>(velocity.x * dt);
 
 			particle.position.y += static_cast<float>(velocity.y * dt);
 
-			i++;
-		}
+			return false;
+		});
 	}
 
 	// consructor
@@ -308,6 +328,8 @@ private:
 
 	mutable bb::ECS<sf::Vertex, double, double, sf::Vector2f>::C8 m_ecs;
 
+	decltype(m_ecs)::COMMAND_BUFFER m_commands;	// kills of update(dt)
+
 	enum { VERTEX, DALPHA, ALPHA, VELOCITY, 
 		DEFAULT_DIRECTION = 0, 
 		DEFAULT_ANGLE = 20, 
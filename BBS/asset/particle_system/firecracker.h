@@ -19,6 +19,9 @@
 	call update() of 'explo' from Update() and call window.draw(explo) from
 	Render() of game loop to display the effect.
 
+	with lots of particles, call update(dt, MY_GAME.jobs()) instead, to update them in
+	parallel on all the cpu cores.
+
 	here we have used an ECS to store the particles
 	
 	internal arrays are used (by ECS) to store the particles, create() creates
@@ -191,6 +194,41 @@ public:
 		}
 	}
 
+	// same as update(dt), but the particles are updated in parallel on the thread pool
+
+	void update(double dt, JOB_SYSTEM &jobs)
+	{
+		m_ecs.parallel_each<VERTEX, START, END, ELAPSED_TIME, DURATION, DALPHA, ALPHA>(jobs, [dt](sf::Vertex &particle, sf::Vector2f &start, sf::Vector2f &end, double &elapsed_time, double &duration, double &dalpha, double &alpha)
+		{
+			// calculating next possible value of alpha of the particle
+
+			alpha -= dalpha * dt;
+
+			if(alpha <= 0)
+			{
+				return true;	// not visible, kill it (after all the particles are updated)
+			}
+
+			elapsed_time += dt;
+
+			float time_ratio = elapsed_time / duration;
+
+			// updating alpha of the particle
+
+			particle.color.a = static_cast<uint8_t>(alpha);
+
+			// calculating current position
+
+			particle.position = start + (end - start) * ((time_ratio >= 1.0f) ? 1.0f : 1.0f - powf(15.0f, -10.0f * time_ratio));
+
+			// adding gravity effect .5 * g * t ^ 2, (.5 * g) = 4, I found this is the best value
+
+			particle.position.y += 14 * elapsed_time * elapsed_time;
+
+			return false;
+		});
+	}
+
 private:
 
 	void draw(sf::RenderTarget& target, sf::RenderStates states) const override
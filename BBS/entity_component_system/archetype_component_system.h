@@ -0,0 +1,735 @@
+#pragma once
+
+#include<vector>
+
+#include<tuple>
+
+#include<array>
+
+#include<memory>
+
+#include<utility>
+
+#include<unordered_map>
+
+#include<algorithm>
+
+#include<type_traits>
+
+#include<cstddef>
+
+#include<cstdint>
+
+#include"entity_component_system.h"
+
+
+namespace bb
+{
+	template<size_t CHUNK_SIZE = 256>
+
+	struct ARCHETYPE;
+
+	template<typename ENTITY_BITMASK_TYPE, size_t CHUNK_SIZE, typename... component_types>
+
+	class ARCHETYPE_COMPONENT_SYSTEM;
+}
+
+
+
+/*
+	This is another storage for the ECS (see entity_component_system.h), it stores the entities
+	grouped by their bitmasks (archetypes), instead of one vector of each component for all the
+	entities.
+
+	**********************************
+	Let me describe it's inner working
+	**********************************
+
+	Archetypes and Chunks:
+	----------------------
+
+	All the entities with the same bitmask (same set of components) belong to the same archetype,
+	an archetype stores its entities in fixed size chunks, each chunk holds CHUNK_SIZE entities,
+	and an array of each component of the archetype, the components the archetype doesn't have
+	are not stored at all.
+
+	archetype (bitmask 1011) : chunk 0, chunk 1, ...
+
+	chunk 0 :
+	component_a : [0][1][2]...[CHUNK_SIZE - 1]
+	component_c : [0][1][2]...[CHUNK_SIZE - 1]
+	component_d : [0][1][2]...[CHUNK_SIZE - 1]
+
+	So a component that only a few entities have, costs memory only for those entities, and a
+	query (each<>()) visits only the archetypes having all of its components, touching only the
+	arrays of those components.
+
+	Like the default ECS, the entities of an archetype are kept packed, a killed entity is replaced
+	by the last entity of its archetype.
+
+	Adding and Removing Components:
+	-------------------------------
+
+	Adding or removing components changes the bitmask of an entity, so it moves the entity (its
+	components) to the archetype of the new bitmask, this is slower than the default ECS, where it
+	only changes a bit, so add or remove components rarely (not in each update).
+
+	The components of a new entity and the components added to an entity are set to their default
+	value (T{}).
+
+	Handles:
+	--------
+
+	As the entities move, they are referred by handles (index of a slot + generation), a slot keeps
+	the archetype and the row of the entity, and the generation, exactly like the handles of the
+	default ECS.
+
+	*******************
+	How to use this ECS
+	*******************
+
+	ECS<ARCHETYPE<>, int, float, pos, int>::C8 ecs;	// chunks of 256 entities
+
+	ECS<ARCHETYPE<64>, int, float, pos, int>::C8 ecs;	// chunks of 64 entities
+
+	it works mostly like the default ECS,
+
+	auto entity = ecs.create_entity<comp0, comp2>();	// or create_entity() to add all the components
+
+	entity.add<comp1>();
+
+	entity.remove<comp0>();
+
+	entity.get<comp2>().x = 10;
+
+	entity.has<comp1, comp2>();
+
+	auto handle = entity.handle();	// same as entity.id
+
+	ecs.alive(handle);
+
+	auto same_entity = ecs.entity(handle);
+
+	ecs.kill_entity(entity);	// or, ecs.kill_entity(handle)
+
+	ecs.each<comp1, comp2>([](float &f, pos &p) { ... });
+
+	ecs.each<comp1, comp2>([](auto handle, float &f, pos &p) { ... });	// handle of the entity as the first argument
+
+	Differences from the default ECS:
+	---------------------------------
+
+	there are no entity ids, ENTITY::id is a handle, so there is no component<>() vector and no
+	entity(size_t id), use each<>() to visit the entities.
+
+	an ENTITY object stays valid while the entity is alive, even if other entities are killed or
+	its components are added or removed.
+
+	------------------
+	~~~~ Caution: ~~~~
+	------------------
+
+	get<>() doesn't check if the entity has the component, and entity() doesn't check the handle,
+	for the sake of performance.
+
+	!!!! References to the components become invalid after adding or removing components of their
+	!!!! entity or killing any entity of its archetype (entities move)
+
+	!!!! Don't create or kill entities or add or remove components inside each<>()
+*/
+
+template<size_t CHUNK_SIZE>
+
+struct bb::ARCHETYPE
+{
+	static_assert(CHUNK_SIZE > 0, "!!!! CHUNK_SIZE of ARCHETYPE must be > 0 !!!!");
+};
+
+
+
+template<typename ENTITY_BITMASK_TYPE, size_t CHUNK_SIZE, typename... component_types>
+
+class bb::ARCHETYPE_COMPONENT_SYSTEM
+{
+	static_assert(
+
+		(sizeof... (component_types) <= sizeof(ENTITY_BITMASK_TYPE) * 8),
+
+		"!!!! Number of components must not exceed size of an entity bitmask !!!!"
+
+	);
+
+
+
+	static_assert(
+
+		std::is_unsigned_v<ENTITY_BITMASK_TYPE>,
+
+		"!!!! ENTITY_BITMASK_TYPE must be unsigned !!!!"
+
+	);
+
+
+
+	template<uint8_t index_of_component>
+
+	using component_type = std::tuple_element_t<index_of_component, std::tuple<component_types...>>;
+
+
+
+	public:
+
+
+
+	// stable reference to an entity
+
+	struct HANDLE
+	{
+		uint32_t index = UINT32_MAX;	// index of the slot, UINT32_MAX => no entity
+
+		uint32_t generation = 0;	// generation of the slot when the handle was created
+
+
+		constexpr bool operator==(const HANDLE&) const noexcept = default;
+	};
+
+
+
+	// bitmask with the bits of given components set, computed in compile time
+
+	template<uint8_t... index_of_component> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	static constexpr ENTITY_BITMASK_TYPE mask = (ENTITY_BITMASK_TYPE)(((ENTITY_BITMASK_TYPE)1 << index_of_component) | ... | 0);
+
+
+
+	/*
+		wrapper for an entity, works like the ENTITY of the default ECS, but it holds the handle
+		of the entity instead of an entity id
+	*/
+
+	struct ENTITY
+	{
+		HANDLE id;	// handle of the entity
+
+		ARCHETYPE_COMPONENT_SYSTEM &ecs;	// reference to ECS object to access ECS methods
+
+
+		constexpr explicit ENTITY(ARCHETYPE_COMPONENT_SYSTEM &ecs_in, HANDLE id_in = {}) : ecs(ecs_in), id(id_in)
+		{}
+
+
+		/*
+			add multiple components to this entity (moves it to another archetype)
+		*/
+
+		template<uint8_t... index_of_component> requires(
+			(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+		)
+
+		void add()
+		{
+			ecs.move_entity(id.index, ecs.archetypes[ecs.slots[id.index].archetype]->mask | mask<index_of_component...>);
+		}
+
+
+		/*
+			remove multiple components from this entity (moves it to another archetype)
+		*/
+
+		template<uint8_t... index_of_component> requires(
+			(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+		)
+
+		void remove()
+		{
+			ecs.move_entity(id.index, ecs.archetypes[ecs.slots[id.index].archetype]->mask & ~mask<index_of_component...>);
+		}
+
+
+		/*
+			get a component of this entity
+		*/
+
+		template<uint8_t index_of_component>
+
+		component_type<index_of_component>& get() noexcept
+		{
+			const SLOT &slot = ecs.slots[id.index];
+
+			CHUNK &chunk = *ecs.archetypes[slot.archetype]->chunks[slot.row / CHUNK_SIZE];
+
+			return std::get<index_of_component>(chunk.data)[slot.row % CHUNK_SIZE];
+		}
+
+
+		/*
+			does this entity has the given components or not
+		*/
+
+		template<uint8_t... index_of_component> requires(
+			(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+		)
+
+		bool has() const noexcept
+		{
+			return ecs.archetypes[ecs.slots[id.index].archetype]->mask & mask<index_of_component...>;
+		}
+
+
+		// checks if this entity is still alive
+
+		bool valid() const noexcept
+		{
+			return ecs.alive(id);
+		}
+
+
+		constexpr HANDLE handle() const noexcept
+		{
+			return id;
+		}
+	};
+
+
+
+	private:
+
+
+
+	// CHUNK_SIZE entities of an archetype, only the components of the archetype are allocated
+
+	struct CHUNK
+	{
+		std::tuple<std::unique_ptr<component_types[]>...> data;
+
+		std::array<uint32_t, CHUNK_SIZE> slot;	// slot of each entity
+
+
+		explicit CHUNK(ENTITY_BITMASK_TYPE mask_in)
+		{
+			[&]<size_t... index>(std::index_sequence<index...>)
+			{
+				((((mask_in >> index) & 1) ? (void)(std::get<index>(data) = std::make_unique<component_types[]>(CHUNK_SIZE)) : (void)0), ...);
+			}(std::index_sequence_for<component_types...>{});
+		}
+	};
+
+
+	// all the entities with the same bitmask
+
+	struct ARCHETYPE_STORE
+	{
+		ENTITY_BITMASK_TYPE mask;
+
+		std::vector<std::unique_ptr<CHUNK>> chunks;
+
+		size_t count = 0;	// no. of entities
+	};
+
+
+	// a slot keeps the place of an alive entity, or the next free slot (in row) if it's free
+
+	struct SLOT
+	{
+		uint32_t archetype;
+
+		uint32_t row;	// row of the entity in the archetype or next free slot
+
+		uint32_t generation;
+	};
+
+
+	std::vector<std::unique_ptr<ARCHETYPE_STORE>> archetypes;
+
+	std::unordered_map<ENTITY_BITMASK_TYPE, uint32_t> archetype_of;	// index of the archetype of each bitmask
+
+	std::vector<SLOT> slots;
+
+	uint32_t free_slot;	// first free slot, UINT32_MAX => no free slot
+
+	size_t count;	// no. of alive entities
+
+
+	// index of the archetype of a bitmask, creates the archetype if needed
+
+	uint32_t find_archetype(ENTITY_BITMASK_TYPE mask_in)
+	{
+		auto found = archetype_of.find(mask_in);
+
+		if(found != archetype_of.end())
+		{
+			return found->second;
+		}
+
+		archetypes.push_back(std::make_unique<ARCHETYPE_STORE>());
+
+		archetypes.back()->mask = mask_in;
+
+		return archetype_of[mask_in] = (uint32_t)(archetypes.size() - 1);
+	}
+
+
+	// add a row for the entity of a slot at the end of an archetype, returns the row
+
+	uint32_t push_row(uint32_t archetype, uint32_t slot)
+	{
+		ARCHETYPE_STORE &store = *archetypes[archetype];
+
+		size_t row = store.count++;
+
+		if(row / CHUNK_SIZE == store.chunks.size())
+		{
+			store.chunks.push_back(std::make_unique<CHUNK>(store.mask));
+		}
+
+		store.chunks[row / CHUNK_SIZE]->slot[row % CHUNK_SIZE] = slot;
+
+		return (uint32_t)row;
+	}
+
+
+	// remove a row from an archetype, the last entity of the archetype replaces it
+
+	void pop_row(uint32_t archetype, uint32_t row)
+	{
+		ARCHETYPE_STORE &store = *archetypes[archetype];
+
+		size_t last = --store.count;
+
+		if(row != last)
+		{
+			CHUNK &to = *store.chunks[row / CHUNK_SIZE], &from = *store.chunks[last / CHUNK_SIZE];
+
+			copy_components(store.mask, to, row % CHUNK_SIZE, from, last % CHUNK_SIZE);
+
+			to.slot[row % CHUNK_SIZE] = from.slot[last % CHUNK_SIZE];
+
+			slots[to.slot[row % CHUNK_SIZE]].row = row;
+		}
+
+		// free the chunks no longer needed, keeping one spare chunk
+
+		while(store.chunks.size() > (store.count + CHUNK_SIZE - 1) / CHUNK_SIZE + 1)
+		{
+			store.chunks.pop_back();
+		}
+	}
+
+
+	// move the components given in the bitmask from one row to another (of any archetype)
+
+	static void copy_components(ENTITY_BITMASK_TYPE mask_in, CHUNK &to, size_t to_index, CHUNK &from, size_t from_index)
+	{
+		[&]<size_t... index>(std::index_sequence<index...>)
+		{
+			((((mask_in >> index) & 1) ? (void)(std::get<index>(to.data)[to_index] = std::move(std::get<index>(from.data)[from_index])) : (void)0), ...);
+		}(std::index_sequence_for<component_types...>{});
+	}
+
+
+	// set the components given in the bitmask of a row to their default values
+
+	static void reset_components(ENTITY_BITMASK_TYPE mask_in, CHUNK &chunk, size_t index)
+	{
+		[&]<size_t... index_of_component>(std::index_sequence<index_of_component...>)
+		{
+			((((mask_in >> index_of_component) & 1) ? (void)(std::get<index_of_component>(chunk.data)[index] = component_types{}) : (void)0), ...);
+		}(std::index_sequence_for<component_types...>{});
+	}
+
+
+	// move the entity of a slot to the archetype of a new bitmask
+
+	void move_entity(uint32_t slot, ENTITY_BITMASK_TYPE new_mask)
+	{
+		uint32_t from = slots[slot].archetype, from_row = slots[slot].row;
+
+		ENTITY_BITMASK_TYPE old_mask = archetypes[from]->mask;
+
+		if(new_mask == old_mask)
+		{
+			return;
+		}
+
+		uint32_t to = find_archetype(new_mask);
+
+		uint32_t to_row = push_row(to, slot);
+
+		CHUNK &to_chunk = *archetypes[to]->chunks[to_row / CHUNK_SIZE];
+
+		CHUNK &from_chunk = *archetypes[from]->chunks[from_row / CHUNK_SIZE];
+
+		copy_components(old_mask & new_mask, to_chunk, to_row % CHUNK_SIZE, from_chunk, from_row % CHUNK_SIZE);
+
+		// the new components start with their default values
+
+		reset_components(new_mask & ~old_mask, to_chunk, to_row % CHUNK_SIZE);
+
+		pop_row(from, from_row);
+
+		slots[slot].archetype = to;
+
+		slots[slot].row = to_row;
+	}
+
+
+	// create an entity with the given bitmask
+
+	ENTITY create(ENTITY_BITMASK_TYPE mask_in)
+	{
+		uint32_t index;
+
+		if(free_slot != UINT32_MAX)
+		{
+			index = free_slot;
+
+			free_slot = slots[index].row;
+		}
+		else
+		{
+			index = (uint32_t)slots.size();
+
+			slots.push_back({0, 0, 0});
+		}
+
+		uint32_t archetype = find_archetype(mask_in);
+
+		slots[index].archetype = archetype;
+
+		slots[index].row = push_row(archetype, index);
+
+		reset_components(mask_in, *archetypes[archetype]->chunks[slots[index].row / CHUNK_SIZE], slots[index].row % CHUNK_SIZE);
+
+		count++;
+
+		return ENTITY(*this, {index, slots[index].generation});
+	}
+
+
+
+	public:
+
+
+
+	ARCHETYPE_COMPONENT_SYSTEM() : free_slot(UINT32_MAX), count(0)
+	{}
+
+
+	ARCHETYPE_COMPONENT_SYSTEM(const ARCHETYPE_COMPONENT_SYSTEM&) = delete;
+
+	ARCHETYPE_COMPONENT_SYSTEM& operator=(const ARCHETYPE_COMPONENT_SYSTEM&) = delete;
+
+
+
+	// entity functions
+
+
+
+	/*
+		adds a new entity with the given components to the ECS and returns it as an entity object
+	*/
+
+	template<uint8_t... index_of_component> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	ENTITY create_entity()
+	{
+		return create(mask<index_of_component...>);
+	}
+
+
+	/*
+		overloaded version of previous function
+
+		it adds all available components to the new entity
+	*/
+
+	ENTITY create_entity()
+	{
+		return create((ENTITY_BITMASK_TYPE)-1 >> (sizeof(ENTITY_BITMASK_TYPE) * 8 - sizeof...(component_types)));
+	}
+
+
+	/*
+		kills the entity if it's alive, the last entity of its archetype takes its place
+	*/
+
+	void kill_entity(HANDLE handle)
+	{
+		if(alive(handle))
+		{
+			SLOT &slot = slots[handle.index];
+
+			pop_row(slot.archetype, slot.row);
+
+			// the slot becomes free, with a new generation, so that its handles become stale
+
+			slot.generation++;
+
+			slot.row = free_slot;
+
+			free_slot = handle.index;
+
+			count--;
+		}
+	}
+
+
+	void kill_entity(const ENTITY &entity)
+	{
+		kill_entity(entity.id);
+	}
+
+
+	/*
+		access an entity as an entity object using its handle
+
+		!!!! Caution: the handle is not checked, use alive() if it may be stale !!!!
+	*/
+
+	ENTITY entity(HANDLE handle) noexcept
+	{
+		return ENTITY(*this, handle);
+	}
+
+
+	// is the entity referred by the handle still alive (not killed)
+
+	bool alive(HANDLE handle) const noexcept
+	{
+		return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+	}
+
+
+	// reserve space for handles of "extra" new entities (components are allocated chunk by chunk)
+
+	void reserve_extra(size_t extra)
+	{
+		slots.reserve(count + extra);
+	}
+
+
+
+	// query functions
+
+
+
+	/*
+		calls fn(components...) or fn(handle, components...) for each entity that has all the
+		given components, visits only the archetypes having those components, chunk by chunk
+	*/
+
+	template<uint8_t... index_of_component, typename FUNC> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	void each(FUNC &&fn)
+	{
+		constexpr ENTITY_BITMASK_TYPE required = mask<index_of_component...>;
+
+		for(auto &store : archetypes)
+		{
+			if((store->mask & required) != required)
+			{
+				continue;
+			}
+
+			for(size_t first = 0; first < store->count; first += CHUNK_SIZE)
+			{
+				CHUNK &chunk = *store->chunks[first / CHUNK_SIZE];
+
+				size_t rows = std::min(CHUNK_SIZE, store->count - first);
+
+				auto arrays = std::make_tuple(std::get<index_of_component>(chunk.data).get()...);
+
+				for(size_t i = 0; i < rows; i++)
+				{
+					std::apply([&](auto*... array)
+					{
+						if constexpr (std::is_invocable_v<FUNC, HANDLE, decltype(array[i])...>)
+						{
+							fn(HANDLE{chunk.slot[i], slots[chunk.slot[i]].generation}, array[i]...);
+						}
+						else
+						{
+							fn(array[i]...);
+						}
+					}, arrays);
+				}
+			}
+		}
+	}
+
+
+	constexpr size_t component_count() const noexcept
+	{
+		return sizeof... (component_types);
+	}
+
+
+	// no. of alive entities
+
+	size_t entity_count() const noexcept
+	{
+		return count;
+	}
+
+
+	// no. of archetypes (different bitmasks) created so far
+
+	size_t archetype_count() const noexcept
+	{
+		return archetypes.size();
+	}
+
+
+	// clear all allocated memory
+
+	void clear() noexcept
+	{
+		archetypes.clear();
+
+		archetype_of.clear();
+
+		slots.clear();
+
+		free_slot = UINT32_MAX;
+
+		count = 0;
+	}
+
+
+	// returns true if all entities are dead
+
+	bool empty() const noexcept
+	{
+		return count == 0;
+	}
+};
+
+
+
+/*
+	ECS<ARCHETYPE<CHUNK_SIZE>, component types...>::C8 selects the archetype storage, same as ECS<...>
+	otherwise
+*/
+
+namespace bb
+{
+	template<size_t CHUNK_SIZE, typename... component_types>
+
+	struct ECS<ARCHETYPE<CHUNK_SIZE>, component_types...>
+	{
+		using C8 = ARCHETYPE_COMPONENT_SYSTEM<uint8_t, CHUNK_SIZE, component_types...>;
+
+		using C16 = ARCHETYPE_COMPONENT_SYSTEM<uint16_t, CHUNK_SIZE, component_types...>;
+
+		using C32 = ARCHETYPE_COMPONENT_SYSTEM<uint32_t, CHUNK_SIZE, component_types...>;
+
+		using C64 = ARCHETYPE_COMPONENT_SYSTEM<uint64_t, CHUNK_SIZE, component_types...>;
+	};
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include<vector>
+
+#include<atomic>
+
+#include<bit>
+
+#include<cstddef>
+
+#include<cstdint>
+
+#include"sparse_set.h"	// COMPONENT_STORAGE
+
+
+namespace bb
+{
+	template<typename T>
+
+	struct TRACKED;
+
+	class CHANGE_SET;
+}
+
+
+
+/*
+	Wrap a component type in TRACKED<> to let ENTITY_COMPONENT_SYSTEM (see entity_component_system.h)
+	remember which entities changed it,
+
+	ECS<TRACKED<sf::Vector2f>, double>::C8 ecs;	// changes of the positions are tracked
+
+	the component is stored as usual (TRACKED<SPARSE<T>> is stored in a sparse set), but the
+	ECS also keeps a CHANGE_SET for it, a bit for each entity, set when the component may have
+	been modified, i.e., when it's accessed with entity.get<>() or each<>(), or when it's added.
+
+	ecs.changed<POSITION>([&](size_t id, const sf::Vector2f &position) { ... });	// only the changed ones
+
+	ecs.clear_changed<POSITION>();	// forget the changes, after handling them
+
+	so the render or the network code does work proportional to the no. of changes, not the no.
+	of entities.
+
+	**********************************
+	Let me describe it's inner working
+	**********************************
+
+	entity_id    ->  0 ... 63   64 ... 127   128 ... 191
+	bits         : [  word 0  ][  word 1   ][  word 2   ]	a bit for each entity
+	summary      : [ 0 1 0 ... ]	a bit for each word of bits, set if the word may be non zero
+
+	setting a bit sets its summary bit too, so finding the changes skips 4096 unchanged entities
+	with a single test of a summary word, and clearing the changes zeros only the marked words.
+*/
+
+template<typename T>
+
+struct bb::TRACKED
+{
+	using type = T;
+};
+
+
+
+class bb::CHANGE_SET
+{
+	std::vector<uint64_t> bits;	// a bit for each entity
+
+	std::vector<uint64_t> summary;	// a bit for each word of bits
+
+
+	public:
+
+
+	// make room for the entities with ids < entities
+
+	void resize(size_t entities)
+	{
+		bits.resize((entities + 63) / 64);
+
+		summary.resize((bits.size() + 63) / 64);
+	}
+
+
+	void set(size_t id) noexcept
+	{
+		bits[id >> 6] |= (uint64_t)1 << (id & 63);
+
+		summary[id >> 12] |= (uint64_t)1 << ((id >> 6) & 63);
+	}
+
+
+	/*
+		same as set(), but many threads can call it at the same time, as long as no two threads
+		set the bits of the same word of 64 entities (the batches of parallel_each<>())
+	*/
+
+	void set_shared(size_t id) noexcept
+	{
+		bits[id >> 6] |= (uint64_t)1 << (id & 63);
+
+		uint64_t bit = (uint64_t)1 << ((id >> 6) & 63);
+
+		if(!(std::atomic_ref<uint64_t>(summary[id >> 12]).load(std::memory_order_relaxed) & bit))
+		{
+			std::atomic_ref<uint64_t>(summary[id >> 12]).fetch_or(bit, std::memory_order_relaxed);
+		}
+	}
+
+
+	void reset(size_t id) noexcept
+	{
+		bits[id >> 6] &= ~((uint64_t)1 << (id & 63));
+	}
+
+
+	bool test(size_t id) const noexcept
+	{
+		return bits[id >> 6] >> (id & 63) & 1;
+	}
+
+
+	// entity "from" takes the id "to", its bit moves with it, an entity moved onto itself keeps its bit
+
+	void move(size_t from, size_t to) noexcept
+	{
+		if(from == to)
+		{
+			return;
+		}
+
+		bool changed = test(from);
+
+		reset(from);
+
+		if(changed)
+		{
+			set(to);
+		}
+		else
+		{
+			reset(to);
+		}
+	}
+
+
+	// set the bits of the entities with ids < count
+
+	void set_all(size_t count) noexcept
+	{
+		for(size_t id = 0; id < count; id++)
+		{
+			set(id);
+		}
+	}
+
+
+	// calls fn(entity id) for each set bit, in increasing order of the ids
+
+	template<typename FUNC>
+
+	void for_each(FUNC &&fn) const
+	{
+		for(size_t s = 0; s < summary.size(); s++)
+		{
+			for(uint64_t words = summary[s]; words; words &= words - 1)
+			{
+				size_t word = s * 64 + std::countr_zero(words);
+
+				for(uint64_t set_bits = bits[word]; set_bits; set_bits &= set_bits - 1)
+				{
+					fn(word * 64 + std::countr_zero(set_bits));
+				}
+			}
+		}
+	}
+
+
+	// reset all the bits, touches only the words marked in the summary
+
+	void clear() noexcept
+	{
+		for(size_t s = 0; s < summary.size(); s++)
+		{
+			for(uint64_t words = summary[s]; words; words &= words - 1)
+			{
+				bits[s * 64 + std::countr_zero(words)] = 0;
+			}
+
+			summary[s] = 0;
+		}
+	}
+
+
+	// bytes allocated by the change set
+
+	size_t bytes() const noexcept
+	{
+		return sizeof(uint64_t) * (bits.capacity() + summary.capacity());
+	}
+
+
+	// free the memory
+
+	void release() noexcept
+	{
+		bits.clear();
+
+		summary.clear();
+	}
+};
+
+
+
+namespace bb
+{
+	template<typename T>
+
+	struct COMPONENT_STORAGE<TRACKED<T>> : COMPONENT_STORAGE<T>
+	{
+		static constexpr bool tracked = true;
+	};
+}
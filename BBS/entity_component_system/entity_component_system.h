@@ -6,6 +6,46 @@
 
 #include<type_traits>
 
+#include<algorithm>
+
+#include<cstddef>
+
+#include<cstdint>
+
+#include<bit>
+
+#include<utility>
+
+#include<functional>
+
+#include<mutex>
+
+#include<array>
+
+#include<istream>
+
+#include<ostream>
+
+#include<iterator>
+
+#include"sparse_set.h"	// storage of SPARSE<T> components
+
+#include"change_set.h"	// changes of TRACKED<T> components
+
+#include"../utility/default_init_allocator.h"	// component vectors are not zero filled on resize
+
+#include"../utility/binary_stream.h"	// to save and load the ECS
+
+#include"../job_system/job_system.h"	// thread pool for parallel_each()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+	#include<emmintrin.h>	// to test the entity bitmasks 16 bytes at a time
+
+	#define BB_ECS_SSE2
+
+#endif
+
 
 namespace bb
 {
@@ -92,6 +132,22 @@ namespace bb
 
 	entity 3 replaces entity 0 at the back
 
+	Handles (Generational Ids):
+	---------------------------
+
+	As the entities move when another entity is killed, entity ids are not stable, so the
+	ECS also gives each entity a handle, that never changes while the entity is alive.
+
+	A handle is an index in a table of slots plus a generation, each slot keeps the current
+	entity id of its entity and a generation, the entity list keeps the slot of each entity.
+
+	handle {slot index, generation}  ->  slot {entity id, generation}  ->  entity id
+
+	When an entity moves, only its slot is updated, when an entity is killed its slot's
+	generation is incremented and the slot is reused for a new entity later, so a handle of a
+	killed entity never matches the generation of its slot again, that's how the stale handles
+	are detected, in O(1), without touching the packed component vectors.
+
 	*******************
 	How to use this ECS
 	*******************
@@ -127,7 +183,9 @@ namespace bb
 	of components.
 
 	100 is the "RESERVE_EXTRA_ENTITIES", if create_entity() runs out of space, it extends
-	internal vectors by "RESERVE_EXTRA_ENTITIES" to store new entities.
+	internal vectors by "RESERVE_EXTRA_ENTITIES" or by their current size, whichever is larger,
+	to store new entities, so the space doubles as the ECS grows and creating n entities costs
+	only about log(n) reallocations.
 
 	Rest of the arguments specify component types.
 
@@ -160,8 +218,11 @@ namespace bb
 	create_entity() returns an ENTITY object, ENTITY is a wrapper structure for an enity.
 	More on ENTITY later.
 
-	create_entity() can allocate extra storage for "RESERVE_EXTRA_ENTITIES" number of entities
-	if required.
+	create_entity() can allocate extra storage for "RESERVE_EXTRA_ENTITIES" (or more) number of
+	entities if required.
+
+	!!!! The components of a new entity are not set to any value (the vectors don't zero fill the
+	!!!! new space, see default_init_allocator.h), set each component you added to the entity
 
 	Deleting an Entity:
 	-------------------
@@ -187,6 +248,28 @@ namespace bb
 	**** kill other entities, don't kill the i'th entity afterwards, and also kill other entities carefully ****
 	**** to make sure no entity gets deleted accidentally or fails to delete. ****
 
+	**** Or, use handles (see below) to refer to the entities you kill or keep for later ****
+
+	Stable Handles:
+	---------------
+
+	auto handle = ecs.handle(id);	// or entity.handle(), or ecs.create_entity().handle()
+
+	Unlike an entity id, a handle keeps referring to the same entity, no matter how many entities are
+	killed or created, store handles (not ids) when you need to refer to an entity later (say, the
+	target of a missile).
+
+	ecs.alive(handle);	// false once the entity is killed
+
+	auto entity = ecs.entity(handle);	// ENTITY object of the entity, don't use it if it's not alive
+
+	ecs.kill_entity(handle);	// kills the entity, if it's alive (so killing twice is harmless)
+
+	entity.id changes when the entity moves, so get a new ENTITY object from the handle each time
+	you need it.
+
+	A default constructed handle refers to no entity, alive() is always false for it.
+
 
 	Accessing a Component Vector:
 	-----------------------------
@@ -196,7 +279,7 @@ namespace bb
 	Takes "component id" as template argument.
 	
 	Returns a reference to the component vector, note that the type of the returned vector
-	reference is "std::vector<component type>".
+	reference is "std::vector<component type, DEFAULT_INIT_ALLOCATOR<component type>>", so use auto&.
 
 	Accessing an Entity:
 	--------------------
@@ -227,6 +310,140 @@ namespace bb
 
 	Create references only under extreme performance contraints & at your own risk.
 
+	Iterating over the Entities with Given Components:
+	--------------------------------------------------
+
+	// calls the function for each entity that has all the given components
+
+	ecs.each<comp0, comp2>([](int &a, pos &p) { p.x += a; });
+
+	// the function may take the entity id too, as the first argument
+
+	ecs.each<comp0, comp2>([&](size_t id, int &a, pos &p) { ... });
+
+	// or, iterate over the ids of those entities
+
+	for(size_t id : ecs.view<comp0, comp2>())
+	{
+		auto entity = ecs.entity(id);
+		...
+	}
+
+	The function receives references to the components, in the order of the component ids given
+	as template arguments, each<>() with no component id visits all the entities.
+
+	The bitmask of the given components is computed in compile time, and the entity bitmasks are
+	tested 16 bytes at a time (with SSE2, if available), so the entities that don't match are
+	skipped quickly, without a branch for each of them.
+
+	If one of the given components is SPARSE<T> (see below), each<>() visits only the entities having
+	the smallest of those sparse components, instead of testing all the entity bitmasks.
+
+	!!!! Don't create or kill entities inside each<>() or a view<>() loop, as the entities move, record
+	!!!! them in a COMMAND_BUFFER instead (see "Deferred Commands" below)
+
+	Parallel Iteration:
+	-------------------
+
+	// same as each<>(), but the entities are split in batches, run in parallel on a thread pool
+
+	ecs.parallel_each<comp0, comp2>(MY_GAME.jobs(), [](int &a, pos &p) { p.x += a; });
+
+	// the function may return a bool, true => kill this entity
+
+	ecs.parallel_each<comp0>(jobs, [dt](float &life) { life -= dt; return life <= 0; });
+
+	Each batch starts at a multiple of 64 entities, so no two threads set bits in the same 64 entity
+	word of a CHANGE_SET (see change_set.h). The vectors are not aligned to cache lines, so two batches
+	may still share a cache line at their boundary, which costs a little but is safe. The kills are not
+	done while iterating (the entities would move under the other threads), they are collected and
+	done all at once after all the batches are over (see "Deferred Commands" below).
+
+	!!!! the function runs on many threads at the same time, it must modify only the components of
+	!!!! its own entity
+
+	Deferred Commands:
+	------------------
+
+	decltype(ecs)::COMMAND_BUFFER commands;	// keep it with the ecs, it reuses its memory
+
+	ecs.each<comp0>([&](size_t id, int &life)
+	{
+		if(--life <= 0)
+		{
+			commands.kill(ecs.handle(id));	// recorded, not done yet
+		}
+	});
+
+	commands.flush(ecs);	// now all the recorded commands are done
+
+	A COMMAND_BUFFER records the entity changes to be done later, when no loop is running over the
+	entities, so inside a loop you can kill any entity (not just the i'th), without the "don't
+	increment i after a kill" trick, it records,
+
+	commands.kill(handle);	// or kill(entity)
+
+	commands.add<comp0, comp3>(handle);
+
+	commands.remove<comp1>(handle);
+
+	commands.create_entity();	// or create_entity<comp0, comp2>()
+
+	commands.create_entity<comp0>([](auto &entity) { entity.get<comp0>() = 10; });	// to set up the new entity
+
+	The entities are recorded by handles, so a command for an entity already killed is ignored, and
+	killing an entity twice is harmless. Recording locks the buffer, so it can be used from many
+	threads at the same time (say, inside parallel_each<>()).
+
+	flush() does the adds and removes first (in the order they were recorded), then all the kills
+	at once, then the creates, the new entities are not visited by the loop that created them.
+
+	The point of recording the kills is that they are safe during a loop, not speed. They are done
+	all at once, instead of moving the top entity to each killed entity, the alive entities above
+	the new top fill the holes left by the killed entities below it, so each entity moves at most
+	once, and the moves are done one component vector at a time. That pays off only with many
+	components and many entities (see kill_swap and kill_batch in benchmark/ecs_benchmark.cpp),
+	with a few components recording and flushing costs more per kill than kill_entity().
+
+	Sparse Components:
+	------------------
+
+	ECS<int, float, SPARSE<pos>, int>::C8 ecs;
+
+	A component type wrapped in SPARSE<> is stored in a sparse set (see sparse_set.h) instead of a vector,
+	so it takes memory only for the entities having it, use it for the components only a few entities
+	have (say, "burning" or "selected"), it can be mixed with the usual components in the same ECS.
+
+	Adding and removing a sparse component is still O(1), but unlike the usual components, it adds or
+	removes the component itself, not just a bit, so the value of a sparse component is reset to T{}
+	each time it's added. component<>() returns the SPARSE_SET of a sparse component.
+
+	Change Tracking:
+	----------------
+
+	ECS<TRACKED<int>, float, pos, int>::C8 ecs;
+
+	A component type wrapped in TRACKED<> (see change_set.h) is stored as usual, but the ECS also
+	remembers which entities changed it, so the render or the network code can handle only the
+	changed entities, instead of reading the component of every entity each frame.
+
+	A tracked component is marked as changed when it's added to an entity (by create_entity() or
+	add<>()), or accessed by entity.get<>(), each<>() or parallel_each<>(), as these give a reference
+	that can modify it, read it with entity.read<>() to leave it unmarked.
+
+	ecs.changed<comp0>([&](size_t id, const int &a) { ... });	// for each entity with a changed comp0
+
+	ecs.clear_changed<comp0>();	// forget the changes of comp0, or clear_changed() for all
+
+	ecs.mark_changed<comp0>(id);	// if you modified it through component<>()
+
+	entity.changed<comp0>();	// did this entity change comp0
+
+	changed<>() visits only the entities that still have the component, in increasing order of the
+	ids, finding them costs about one test for each 4096 unchanged entities, clear_changed() costs
+	about the same, a component can be TRACKED<SPARSE<T>> too. After load() every tracked component
+	counts as changed.
+
 	Get the Number of Components and Entities:
 	------------------------------------------
 
@@ -242,6 +459,53 @@ namespace bb
 	Reserves space for 100 new entities, i.e., we can create 100 new entities without allocating any
 	extra space. This is good if you want to add lots of new entities quickly.
 
+	Memory Used by the ECS:
+	-----------------------
+
+	auto stats = ecs.memory_stats();
+
+	stats.bytes	// bytes allocated by the ECS, the entities, their components, the change sets of the
+				// TRACKED<> components and the lists reused by parallel_each<>() and the kills
+
+	stats.reallocations	// no. of times a vector was reallocated to grow, since the ECS was created
+
+	stats.capacity	// no. of entities the ECS can hold without growing
+
+	Killing entities never frees memory, so once the ECS has grown to the largest no. of entities
+	the game needs, creating and killing entities allocates nothing, reallocations stops changing.
+
+	Saving and Loading:
+	-------------------
+
+	std::vector<char> snapshot;
+
+	ecs.save(snapshot);	// the whole state of the ECS, in a compact binary format
+
+	ecs.load(snapshot);	// back to the saved state, returns false if the data is not valid
+
+	std::ofstream file("save.bin", std::ios::binary);
+
+	ecs.save(file);	// or into a stream, and ecs.load(stream) to read it back
+
+	ecs.load(pointer, size);	// or from any block of memory, say, a memory mapped file
+
+	Everything is saved, the entity bitmasks, the components and the handle table, so the handles
+	stored before save() keep working after load(). It's fast enough to take a snapshot each frame
+	(for rollback), keep the same vector to save into, so that its memory is reused.
+
+	Each array (the bitmasks, each component vector) is written with a single copy, and read back
+	with a single copy, there is no parsing for each entity, as long as the component types are
+	trivially copyable (int, float, sf::Vector2f, sf::Vertex...). A component type that is not
+	(say, it holds a std::string) needs write_binary() and read_binary() functions (see
+	binary_stream.h), called for each of its components.
+
+	The data starts with a header holding a version and the size of each component type, load()
+	refuses the data saved by a different version or an ECS with different component types. It also
+	checks the handle table and the owners of the sparse components, so damaged data is refused too,
+	the ECS is left empty when load() returns false.
+
+	!!!! the data is in the byte order of the machine, load it on the same kind of machine
+
 	Deallocate all Dynamic Memory:
 	------------------------------
 
@@ -256,10 +520,12 @@ namespace bb
 	~~~~ Caution: ~~~~
 	------------------
 	
-	entity() doesn't check "Entity Id" for the sake of performance,
+	entity() doesn't check "Entity Id" (or the handle) for the sake of performance,
+
+	But kill_entity() checks "Entity Id" (or the handle) and reserve_extra() varifies its input, because
+	these 2 functions won't be called as frequently as others.
 
-	But kill_entity() checks "Entity Id" and reserve_extra() varifies its input, because these 2 functions
-	won't be called as frequently as others.
+	clear() forgets all the handles, don't use the handles created before clear() after it.
 
 	create_entity(), component<>() check the "Component Ids", given as template arguments, in compile time.
 	
@@ -273,12 +539,12 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 	/*
 		the bitmasks can be 8 to 64 bits long depending on the size of ENTITY_BITMASK_TYPE
-		so, no. of components must be <= sizeof(ENTITY_BITMASK_TYPE)
+		so, no. of components must be <= no. of bits in ENTITY_BITMASK_TYPE
 	*/
 
 	static_assert(
 
-		(sizeof... (component_types) > sizeof(ENTITY_BITMASK_TYPE)),
+		(sizeof... (component_types) <= sizeof(ENTITY_BITMASK_TYPE) * 8),
 
 		"!!!! Number of components must not exceed size of an entity bitmask !!!!"
 		
@@ -296,7 +562,23 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 
 
-	using c_type = std::tuple<std::vector<component_types>...>;	// tuple type to store the components
+	using c_type = std::tuple<typename COMPONENT_STORAGE<component_types>::type...>;	// tuple type to store the components
+
+
+
+	// is the component stored in a sparse set (SPARSE<T>) or not
+
+	template<uint8_t index_of_component>
+
+	static constexpr bool is_sparse = COMPONENT_STORAGE<std::tuple_element_t<index_of_component, std::tuple<component_types...>>>::sparse;
+
+
+
+	// are the changes of the component tracked (TRACKED<T>) or not
+
+	template<uint8_t index_of_component>
+
+	static constexpr bool is_tracked = COMPONENT_STORAGE<std::tuple_element_t<index_of_component, std::tuple<component_types...>>>::tracked;
 
 
 
@@ -304,6 +586,22 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 
 
+	/*
+		stable reference to an entity, see "Stable Handles" above
+	*/
+
+	struct HANDLE
+	{
+		uint32_t index = UINT32_MAX;	// index of the slot, UINT32_MAX => no entity
+
+		uint32_t generation = 0;	// generation of the slot when the handle was created
+
+
+		constexpr bool operator==(const HANDLE&) const noexcept = default;
+	};
+
+
+
 	/*
 		This structure provides a wrapper for each entity, i.e., this structure can be used to represent
 		an entity in this ECS
@@ -379,7 +677,12 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 		entity.get<comp0>();
 
-		returns a reference to the component with Id == comp0 of this entity
+		returns a reference to the component with Id == comp0 of this entity, marks it as changed
+		if it's a TRACKED<> component
+
+		entity.read<comp0>();
+
+		returns a const reference, never marks it as changed
 
 		Check If an Entity Has Given Components or Not:
 		-----------------------------------------------
@@ -423,6 +726,8 @@ class bb::ENTITY_COMPONENT_SYSTEM
 		constexpr void add() noexcept
 		{
 			ecs.entity_list[id] |= (((ENTITY_BITMASK_TYPE)1 << index_of_component) | ...);
+
+			(ecs.template attach<index_of_component>(id), ...);
 		}
 
 		
@@ -437,6 +742,8 @@ class bb::ENTITY_COMPONENT_SYSTEM
 		constexpr void remove() noexcept
 		{
 			ecs.entity_list[id] &= ~(((ENTITY_BITMASK_TYPE)1 << index_of_component) | ...);
+
+			(ecs.template detach<index_of_component>(id), ...);
 		}
 
 		
@@ -447,10 +754,36 @@ class bb::ENTITY_COMPONENT_SYSTEM
 		template<uint8_t index_of_component>
 
 		constexpr std::tuple_element<index_of_component, c_type>::type::value_type& get() noexcept
+		{
+			ecs.template track<index_of_component>(id);
+
+			return ecs.component<index_of_component>()[id];
+		}
+
+
+		/*
+			read a component of this entity, without marking it as changed
+		*/
+
+		template<uint8_t index_of_component>
+
+		constexpr const std::tuple_element<index_of_component, c_type>::type::value_type& read() const noexcept
 		{
 			return ecs.component<index_of_component>()[id];
 		}
 
+
+		/*
+			is the TRACKED<> component of this entity marked as changed
+		*/
+
+		template<uint8_t index_of_component> requires(ENTITY_COMPONENT_SYSTEM::is_tracked<index_of_component>)
+
+		constexpr bool changed() const noexcept
+		{
+			return ecs.changes[index_of_component].test(id);
+		}
+
 		
 		/*
 			does this entity has the given components or not
@@ -474,6 +807,16 @@ class bb::ENTITY_COMPONENT_SYSTEM
 		{
 			return 0 <= id && id <= ecs.top;
 		}
+
+
+		/*
+			stable handle of this entity
+		*/
+
+		constexpr HANDLE handle() const noexcept
+		{
+			return ecs.handle(id);
+		}
 	};
 
 
@@ -482,7 +825,7 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 
 	
-	std::vector<ENTITY_BITMASK_TYPE> entity_list;	// array of entity bitmasks
+	std::vector<ENTITY_BITMASK_TYPE, DEFAULT_INIT_ALLOCATOR<ENTITY_BITMASK_TYPE>> entity_list;	// array of entity bitmasks
 
 	c_type component_tuple;	// stores all the component vectors
 
@@ -490,126 +833,1148 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 	long long top;	// index of the last entity
 
+	/*
+		handle table, a slot keeps the entity id of an alive entity or the index of the
+		next free slot if it's free, slot_of keeps the slot of each entity
+	*/
 
+	struct SLOT
+	{
+		uint32_t dense;	// entity id or next free slot
 
-	public:
+		uint32_t generation;
+	};
 
-	
+	std::vector<SLOT> slots;
 
-	constexpr ENTITY_COMPONENT_SYSTEM() : temp_entity(*this), top(-1)
-	{}
+	std::vector<uint32_t, DEFAULT_INIT_ALLOCATOR<uint32_t>> slot_of;	// same size as entity_list
 
+	uint32_t free_slot;	// first free slot, UINT32_MAX => no free slot
 
+	std::vector<std::vector<size_t>> deferred_kills;	// kills of each batch of parallel_each()
 
-	// component functions
+	std::vector<size_t> kill_list;	// all the kills of parallel_each()
 
+	std::vector<std::pair<size_t, size_t>> moves;	// {from, to} moves of kill_sorted()
 
+	size_t reallocations;	// no. of times a vector was reallocated by reserve_extra()
 
-	/*
-		This function returns a reference to the component vector corresponding to the specified "component id".
-		This function takes the "component id" as a template argument.
+	std::array<CHANGE_SET, sizeof...(component_types)> changes;	// changes of each TRACKED<> component, others stay empty
 
-		Component vectors are indexed based on the order of their types in the template arguments when
-		the ECS object is declared. By convention, indexing starts at 0 and follows the sequence of
-		types provided.
 
-		Internally, components are stored as std::tuple. This function simply accesses an element of this tuple
-		using "component id" as index and returns a reference to it.
-	*/
+	// mark the component of an entity as changed, if it's tracked
 
 	template<uint8_t index_of_component>
 
-	constexpr std::tuple_element<index_of_component, c_type>::type& component()
+	constexpr void track(size_t id) noexcept
 	{
-		return std::get<index_of_component>(component_tuple);
+		if constexpr (is_tracked<index_of_component>)
+		{
+			changes[index_of_component].set(id);
+		}
 	}
 
 
+	// the changes of all the tracked components of entity "from" move to entity "to"
 
-	// entity functions
-
+	constexpr void move_changes(size_t from, size_t to) noexcept
+	{
+		[&]<size_t... index>(std::index_sequence<index...>)
+		{
+			((is_tracked<index> ? changes[index].move(from, to) : void()), ...);
 
+		}(std::index_sequence_for<component_types...>{});
+	}
 
-	/*
-		adds a new entity to the ECS and returns it as an entity object
-		
-		lets you specify the ids of the components to be added to this entity as template arguments
-	*/
 
-	template<uint8_t... index_of_component> requires(
-		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
-	)
+	// the entity at id is killed and nothing takes its place, forget its changes
 
-	constexpr ENTITY create_entity() noexcept
+	constexpr void forget_changes(size_t id) noexcept
 	{
-		// check for overflow
-
-		if (top >= entity_list.size() - 1)
+		[&]<size_t... index>(std::index_sequence<index...>)
 		{
-			// overflowing, increase capacity
+			((is_tracked<index> ? changes[index].reset(id) : void()), ...);
 
-			reserve_extra(RESERVE_EXTRA_ENTITIES);
-		}
+		}(std::index_sequence_for<component_types...>{});
+	}
 
-		temp_entity.id = ++top;
 
-		// setting entity bitmask
+	// bytes allocated by a vector (or a sparse set)
 
-		entity_list[top] = (((ENTITY_BITMASK_TYPE)1 << index_of_component) | ...);
+	template<typename STORAGE>
 
-		return temp_entity;
+	static constexpr size_t bytes_of(const STORAGE &storage) noexcept
+	{
+		if constexpr (requires { storage.bytes(); })
+		{
+			return storage.bytes();
+		}
+		else
+		{
+			return sizeof(typename STORAGE::value_type) * storage.capacity();
+		}
 	}
 
 
-	/*
-		overloaded version of previous function
-		
-		it adds all available components to the new entity
-	*/
+	// space is full, grow by RESERVE_EXTRA_ENTITIES or double the space, whichever is larger
 
-	constexpr ENTITY create_entity() noexcept
+	constexpr void grow() noexcept
 	{
-		// check for overflow
+		reserve_extra(std::max((size_t)RESERVE_EXTRA_ENTITIES, entity_list.size()));
+	}
 
-		if (top >= entity_list.size() - 1)
-		{
-			// overflowing, increase capacity
 
-			reserve_extra(RESERVE_EXTRA_ENTITIES);
+	// component of entity "from" replaces the component of entity "to"
+
+	template<typename STORAGE>
+
+	static constexpr void move_component(STORAGE &storage, size_t from, size_t to)
+	{
+		if constexpr (requires { storage.move_owner(from, to); })
+		{
+			storage.move_owner(from, to);
+		}
+		else
+		{
+			storage[to] = storage[from];
 		}
+	}
 
-		// incrementing the top to push a new entity
 
-		temp_entity.id = ++top;
+	// give a sparse component to an entity (vector components are always there)
 
-		// setting entity bitmask
+	template<uint8_t index_of_component>
 
-		entity_list[top] = -1;
-		
-		return temp_entity;
+	constexpr void attach(size_t id)
+	{
+		if constexpr (is_sparse<index_of_component>)
+		{
+			std::get<index_of_component>(component_tuple).insert(id);
+		}
+
+		track<index_of_component>(id);
 	}
 
 
-	/*
-		exchanges the given entity with the last entity before killing the last entity
-		this ensures a packed entity list, which provides better performance
-	*/
+	// take a sparse component away from an entity
 
-	constexpr void kill_entity(ENTITY &entity) noexcept
-	{
-		// we don't need to check for top here this valid() function does that
+	template<uint8_t index_of_component>
 
-		if(entity.valid())
+	constexpr void detach(size_t id)
+	{
+		if constexpr (is_sparse<index_of_component>)
 		{
-			// killing an entity only if it's valid
+			std::get<index_of_component>(component_tuple).erase(id);
+		}
+	}
 
-			// this entity will be replaced with the last entity
 
-			entity_list[entity.id] = entity_list[top];
+	// component of entity "from" replaces the component of entity "to", for all the moves
 
-			// components of this entity will be replaced with the components of last entity
+	template<typename STORAGE>
 
-			std::apply([&](auto&&... args) {((args[entity.id] = args[top]), ...); }, component_tuple);
+	static constexpr void move_components(STORAGE &storage, const std::vector<std::pair<size_t, size_t>> &moves)
+	{
+		for(auto [from, to] : moves)
+		{
+			if constexpr (requires { storage.move_owner(from, to); })
+			{
+				storage.move_owner(from, to);
+			}
+			else
+			{
+				storage[to] = std::move(storage[from]);
+			}
+		}
+	}
+
+
+	// give (or take away) the sparse components in "bits" to (from) an entity
+
+	constexpr void attach_mask(size_t id, ENTITY_BITMASK_TYPE bits)
+	{
+		[&]<size_t... index>(std::index_sequence<index...>)
+		{
+			((bits >> index & 1 ? attach<index>(id) : void()), ...);
+
+		}(std::index_sequence_for<component_types...>{});
+	}
+
+
+	constexpr void detach_mask(size_t id, ENTITY_BITMASK_TYPE bits)
+	{
+		[&]<size_t... index>(std::index_sequence<index...>)
+		{
+			((bits >> index & 1 ? detach<index>(id) : void()), ...);
+
+		}(std::index_sequence_for<component_types...>{});
+	}
+
+
+	/*
+		kills the entities with the given ids at once, the ids must be valid, sorted and unique
+
+		the alive entities above the new top move to the killed entities below it, so each entity
+		moves at most once, see "Deferred Commands" above
+	*/
+
+	void kill_sorted(const std::vector<size_t> &ids)
+	{
+		if(ids.empty())
+		{
+			return;
+		}
+
+		size_t new_count = entity_count() - ids.size();
+
+		// the slots of the killed entities become free, with new generations
+
+		for(size_t id : ids)
+		{
+			uint32_t index = slot_of[id];
+
+			slots[index].generation++;
+
+			slots[index].dense = free_slot;
+
+			free_slot = index;
+
+			detach_mask(id, (ENTITY_BITMASK_TYPE)-1);
+		}
+
+		// pair each killed entity below new_count with an alive entity above it
+
+		moves.clear();
+
+		auto holes = std::lower_bound(ids.begin(), ids.end(), new_count);	// killed entities below new_count end here
+
+		auto above = holes;	// next killed entity above new_count
+
+		size_t from = new_count;
+
+		for(auto below = ids.begin(); below != holes; below++)
+		{
+			// skip the killed entities above new_count
+
+			while(above != ids.end() && *above == from)
+			{
+				above++;
+
+				from++;
+			}
+
+			moves.push_back({from++, *below});
+		}
+
+		for(auto [from, to] : moves)
+		{
+			entity_list[to] = entity_list[from];
+
+			slot_of[to] = slot_of[from];
+
+			slots[slot_of[to]].dense = (uint32_t)to;
+
+			move_changes(from, to);
+		}
+
+		// the killed entities above new_count are not replaced, forget their changes
+
+		for(auto killed = holes; killed != ids.end(); killed++)
+		{
+			forget_changes(*killed);
+		}
+
+		std::apply([&](auto&... storage) {(move_components(storage, moves), ...); }, component_tuple);
+
+		top = (long long)new_count - 1;
+	}
+
+
+	// give a slot to the new entity at top
+
+	constexpr void attach_slot() noexcept
+	{
+		uint32_t index;
+
+		if(free_slot != UINT32_MAX)
+		{
+			// reuse a free slot
+
+			index = free_slot;
+
+			free_slot = slots[index].dense;
+		}
+		else
+		{
+			index = (uint32_t)slots.size();
+
+			slots.push_back({0, 0});
+		}
+
+		slots[index].dense = (uint32_t)top;
+
+		slot_of[top] = index;
+	}
+
+
+
+	public:
+
+	
+
+	constexpr ENTITY_COMPONENT_SYSTEM() : temp_entity(*this), top(-1), free_slot(UINT32_MAX), reallocations(0)
+	{}
+
+
+
+	// component functions
+
+
+
+	/*
+		This function returns a reference to the component vector corresponding to the specified "component id".
+		This function takes the "component id" as a template argument.
+
+		Component vectors are indexed based on the order of their types in the template arguments when
+		the ECS object is declared. By convention, indexing starts at 0 and follows the sequence of
+		types provided.
+
+		Internally, components are stored as std::tuple. This function simply accesses an element of this tuple
+		using "component id" as index and returns a reference to it.
+	*/
+
+	template<uint8_t index_of_component>
+
+	constexpr std::tuple_element<index_of_component, c_type>::type& component()
+	{
+		return std::get<index_of_component>(component_tuple);
+	}
+
+
+
+	// query functions
+
+
+
+	// bitmask with the bits of given components set, computed in compile time
+
+	template<uint8_t... index_of_component> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	static constexpr ENTITY_BITMASK_TYPE mask = (ENTITY_BITMASK_TYPE)(((ENTITY_BITMASK_TYPE)1 << index_of_component) | ... | 0);
+
+
+
+	private:
+
+
+
+	// no. of entity bitmasks tested at a time (16 bytes)
+
+	static constexpr size_t BLOCK = 16 / sizeof(ENTITY_BITMASK_TYPE);
+
+
+	/*
+		bit i of the result is set if the entity "first + i" has all the components of "required",
+		tests BLOCK entities (less at the end of the list)
+	*/
+
+	uint32_t match_block(size_t first, ENTITY_BITMASK_TYPE required) const noexcept
+	{
+		const ENTITY_BITMASK_TYPE *list = entity_list.data() + first;
+
+		size_t count = entity_count() - first;
+
+		uint32_t bits = 0;
+
+		#ifdef BB_ECS_SSE2
+
+		if(count >= BLOCK)
+		{
+			__m128i masks = _mm_loadu_si128((const __m128i*)list);
+
+			__m128i wanted;
+
+			if constexpr (sizeof(ENTITY_BITMASK_TYPE) == 1)
+			{
+				wanted = _mm_set1_epi8((char)required);
+
+				return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(masks, wanted), wanted));
+			}
+			else if constexpr (sizeof(ENTITY_BITMASK_TYPE) == 2)
+			{
+				wanted = _mm_set1_epi16((short)required);
+
+				__m128i equal = _mm_cmpeq_epi16(_mm_and_si128(masks, wanted), wanted);
+
+				return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(equal, _mm_setzero_si128()));
+			}
+			else if constexpr (sizeof(ENTITY_BITMASK_TYPE) == 4)
+			{
+				wanted = _mm_set1_epi32((int)required);
+
+				__m128i equal = _mm_cmpeq_epi32(_mm_and_si128(masks, wanted), wanted);
+
+				return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(equal));
+			}
+			else
+			{
+				wanted = _mm_set_epi32((int)(required >> 32), (int)required, (int)(required >> 32), (int)required);
+
+				// SSE2 can only compare 32 bit halves, a mask matches if both of its halves match
+
+				__m128i equal = _mm_cmpeq_epi32(_mm_and_si128(masks, wanted), wanted);
+
+				equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+
+				return (uint32_t)_mm_movemask_pd(_mm_castsi128_pd(equal));
+			}
+		}
+
+		#endif
+
+		for(size_t i = 0; i < BLOCK && i < count; i++)
+		{
+			bits |= (uint32_t)((list[i] & required) == required) << i;
+		}
+
+		return bits;
+	}
+
+
+
+	public:
+
+
+
+	/*
+		ids of the entities that have all the given components, use it in a range based for loop,
+		see "Iterating over the Entities with Given Components" above
+	*/
+
+	class VIEW
+	{
+		const ENTITY_COMPONENT_SYSTEM &ecs;
+
+		ENTITY_BITMASK_TYPE required;
+
+
+		public:
+
+
+		class iterator
+		{
+			const ENTITY_COMPONENT_SYSTEM *ecs;
+
+			ENTITY_BITMASK_TYPE required;
+
+			size_t first;	// first entity of the current block
+
+			uint32_t bits;	// matching entities of the current block, not visited yet
+
+
+			// find the next block with a matching entity
+
+			void skip() noexcept
+			{
+				while(bits == 0 && first + BLOCK < ecs->entity_count())
+				{
+					first += BLOCK;
+
+					bits = ecs->match_block(first, required);
+				}
+			}
+
+
+			public:
+
+
+			iterator(const ENTITY_COMPONENT_SYSTEM *ecs_in, ENTITY_BITMASK_TYPE required_in, size_t first_in) noexcept :
+				ecs(ecs_in), required(required_in), first(first_in), bits(0)
+			{
+				if(first < ecs->entity_count())
+				{
+					bits = ecs->match_block(first, required);
+
+					skip();
+				}
+			}
+
+
+			size_t operator*() const noexcept
+			{
+				return first + std::countr_zero(bits);
+			}
+
+
+			iterator& operator++() noexcept
+			{
+				bits &= bits - 1;	// unset the lowest bit
+
+				skip();
+
+				return *this;
+			}
+
+
+			// the iterator reaches the end when no matching entity is left
+
+			bool operator!=(const iterator &other) const noexcept
+			{
+				return bits != 0 || other.bits != 0;
+			}
+		};
+
+
+		VIEW(const ENTITY_COMPONENT_SYSTEM &ecs_in, ENTITY_BITMASK_TYPE required_in) noexcept : ecs(ecs_in), required(required_in)
+		{}
+
+
+		iterator begin() const noexcept
+		{
+			return iterator(&ecs, required, 0);
+		}
+
+
+		iterator end() const noexcept
+		{
+			return iterator(&ecs, required, ecs.entity_count());
+		}
+	};
+
+
+	template<uint8_t... index_of_component> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	VIEW view() const noexcept
+	{
+		return VIEW(*this, mask<index_of_component...>);
+	}
+
+
+	/*
+		calls fn(components...) or fn(entity id, components...) for each entity that has all the
+		given components, see "Iterating over the Entities with Given Components" above
+	*/
+
+	template<uint8_t... index_of_component, typename FUNC> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	void each(FUNC &&fn)
+	{
+		constexpr ENTITY_BITMASK_TYPE required = mask<index_of_component...>;
+
+		auto vectors = std::tie(component<index_of_component>()...);
+
+		auto visit = [&](size_t id)
+		{
+			(track<index_of_component>(id), ...);
+
+			std::apply([&](auto&... vector)
+			{
+				if constexpr (std::is_invocable_v<FUNC, size_t, decltype(vector[id])...>)
+				{
+					fn(id, vector[id]...);
+				}
+				else
+				{
+					fn(vector[id]...);
+				}
+			}, vectors);
+		};
+
+		if constexpr ((is_sparse<index_of_component> || ... || false))
+		{
+			// only the owners of the smallest sparse component can match, visit only them
+
+			const std::vector<uint32_t> *owners = nullptr;
+
+			([&]
+			{
+				if constexpr (is_sparse<index_of_component>)
+				{
+					auto &candidate = component<index_of_component>().owners();
+
+					if(!owners || candidate.size() < owners->size())
+					{
+						owners = &candidate;
+					}
+				}
+			}(), ...);
+
+			for(size_t i = 0; i < owners->size(); i++)
+			{
+				size_t id = (*owners)[i];
+
+				if((entity_list[id] & required) == required)
+				{
+					visit(id);
+				}
+			}
+		}
+		else
+		{
+			size_t count = entity_count();
+
+			for(size_t first = 0; first < count; first += BLOCK)
+			{
+				uint32_t bits = match_block(first, required);
+
+				while(bits)
+				{
+					size_t id = first + std::countr_zero(bits);
+
+					bits &= bits - 1;
+
+					visit(id);
+				}
+			}
+		}
+	}
+
+
+
+	/*
+		calls fn(component) or fn(entity id, component) for each entity whose TRACKED<> component
+		is marked as changed, see "Change Tracking" above
+	*/
+
+	template<uint8_t index_of_component, typename FUNC> requires(
+		index_of_component < sizeof...(component_types) && is_tracked<index_of_component>
+	)
+
+	void changed(FUNC &&fn) const
+	{
+		constexpr ENTITY_BITMASK_TYPE required = mask<index_of_component>;
+
+		const auto &storage = std::get<index_of_component>(component_tuple);
+
+		changes[index_of_component].for_each([&](size_t id)
+		{
+			if(id < entity_count() && (entity_list[id] & required))
+			{
+				if constexpr (std::is_invocable_v<FUNC, size_t, decltype(storage[id])>)
+				{
+					fn(id, storage[id]);
+				}
+				else
+				{
+					fn(storage[id]);
+				}
+			}
+		});
+	}
+
+
+	// forget the changes of a TRACKED<> component
+
+	template<uint8_t index_of_component> requires(
+		index_of_component < sizeof...(component_types) && is_tracked<index_of_component>
+	)
+
+	void clear_changed() noexcept
+	{
+		changes[index_of_component].clear();
+	}
+
+
+	// forget the changes of all the TRACKED<> components
+
+	void clear_changed() noexcept
+	{
+		for(auto &change_set : changes)
+		{
+			change_set.clear();
+		}
+	}
+
+
+	// mark a TRACKED<> component of an entity as changed (say, modified through component<>())
+
+	template<uint8_t index_of_component> requires(
+		index_of_component < sizeof...(component_types) && is_tracked<index_of_component>
+	)
+
+	void mark_changed(size_t id) noexcept
+	{
+		changes[index_of_component].set(id);
+	}
+
+
+
+	/*
+		same as each<>(), but runs the function for the batches of entities in parallel on the
+		thread pool, if the function returns true, the entity is killed after all the batches
+		are done, see "Parallel Iteration" above
+	*/
+
+	template<uint8_t... index_of_component, typename FUNC> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	void parallel_each(JOB_SYSTEM &jobs, FUNC &&fn)
+	{
+		constexpr ENTITY_BITMASK_TYPE required = mask<index_of_component...>;
+
+		constexpr size_t ALIGN = 64;	// batches start at multiples of 64 entities
+
+		size_t count = entity_count();
+
+		if(count == 0)
+		{
+			return;
+		}
+
+		// about 4 batches per thread, rounded up to a multiple of 64 entities
+
+		size_t batch = std::max(count / (jobs.thread_count() * 4), (size_t)1);
+
+		batch = (batch + ALIGN - 1) / ALIGN * ALIGN;
+
+		size_t batches = (count + batch - 1) / batch;
+
+		if(deferred_kills.size() < batches)
+		{
+			deferred_kills.resize(batches);
+		}
+
+		auto vectors = std::tie(component<index_of_component>()...);
+
+		jobs.parallel_for(0, batches, [&](size_t index)
+		{
+			std::vector<size_t> &kills = deferred_kills[index];
+
+			kills.clear();
+
+			size_t last = std::min((index + 1) * batch, count);
+
+			for(size_t first = index * batch; first < last; first += BLOCK)
+			{
+				uint32_t bits = match_block(first, required);
+
+				while(bits)
+				{
+					size_t id = first + std::countr_zero(bits);
+
+					bits &= bits - 1;
+
+					([&]
+					{
+						if constexpr (is_tracked<index_of_component>)
+						{
+							changes[index_of_component].set_shared(id);	// batches don't share the words of 64 entities
+						}
+					}(), ...);
+
+					bool kill = std::apply([&](auto&... vector) -> bool
+					{
+						if constexpr (std::is_invocable_v<FUNC, size_t, decltype(vector[id])...>)
+						{
+							if constexpr (std::is_same_v<std::invoke_result_t<FUNC, size_t, decltype(vector[id])...>, bool>)
+							{
+								return fn(id, vector[id]...);
+							}
+							else
+							{
+								fn(id, vector[id]...);
+
+								return false;
+							}
+						}
+						else
+						{
+							if constexpr (std::is_same_v<std::invoke_result_t<FUNC, decltype(vector[id])...>, bool>)
+							{
+								return fn(vector[id]...);
+							}
+							else
+							{
+								fn(vector[id]...);
+
+								return false;
+							}
+						}
+					}, vectors);
+
+					if(kill)
+					{
+						kills.push_back(id);
+					}
+				}
+			}
+		}, 1);
+
+		// the batches are in order, so are the kills
+
+		kill_list.clear();
+
+		for(size_t index = 0; index < batches; index++)
+		{
+			kill_list.insert(kill_list.end(), deferred_kills[index].begin(), deferred_kills[index].end());
+
+			deferred_kills[index].clear();
+		}
+
+		kill_sorted(kill_list);
+	}
+
+
+
+	/*
+		records creates, kills, adds and removes to be done later by flush(), see "Deferred Commands" above
+	*/
+
+	class COMMAND_BUFFER
+	{
+		enum TYPE : uint8_t {CREATE, KILL, ADD, REMOVE};
+
+		struct COMMAND
+		{
+			TYPE type;
+
+			HANDLE handle;
+
+			ENTITY_BITMASK_TYPE bits;	// components to be created, added or removed
+		};
+
+		std::vector<COMMAND> commands;
+
+		std::vector<std::function<void(ENTITY&)>> creators;	// set up function of each create, may be empty
+
+		std::vector<size_t> kills;	// ids of the entities to be killed, used by flush()
+
+		std::mutex lock;
+
+
+		void record(TYPE type, HANDLE handle, ENTITY_BITMASK_TYPE bits)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			commands.push_back({type, handle, bits});
+		}
+
+
+		void record_create(ENTITY_BITMASK_TYPE bits, std::function<void(ENTITY&)> &&init)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			commands.push_back({CREATE, HANDLE{}, bits});
+
+			creators.push_back(std::move(init));
+		}
+
+
+		public:
+
+
+		COMMAND_BUFFER() = default;
+
+
+		// the recorded commands are copied (not the lock)
+
+		COMMAND_BUFFER(const COMMAND_BUFFER &other) : commands(other.commands), creators(other.creators)
+		{}
+
+
+		COMMAND_BUFFER& operator=(const COMMAND_BUFFER &other)
+		{
+			if(this != &other)
+			{
+				commands = other.commands;
+
+				creators = other.creators;
+			}
+
+			return *this;
+		}
+
+
+		void kill(HANDLE handle)
+		{
+			record(KILL, handle, 0);
+		}
+
+
+		void kill(const ENTITY &entity)
+		{
+			record(KILL, entity.handle(), 0);
+		}
+
+
+		template<uint8_t... index_of_component> requires(
+			(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+		)
+
+		void add(HANDLE handle)
+		{
+			record(ADD, handle, mask<index_of_component...>);
+		}
+
+
+		template<uint8_t... index_of_component> requires(
+			(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+		)
+
+		void remove(HANDLE handle)
+		{
+			record(REMOVE, handle, mask<index_of_component...>);
+		}
+
+
+		// creates an entity with the given components, init(entity) is called to set it up
+
+		template<uint8_t... index_of_component> requires(
+			(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+		)
+
+		void create_entity(std::function<void(ENTITY&)> init = {})
+		{
+			record_create(mask<index_of_component...>, std::move(init));
+		}
+
+
+		// creates an entity with all the components
+
+		void create_entity(std::function<void(ENTITY&)> init = {})
+		{
+			record_create((ENTITY_BITMASK_TYPE)-1, std::move(init));
+		}
+
+
+		// no. of recorded commands
+
+		size_t size() const noexcept
+		{
+			return commands.size();
+		}
+
+
+		// do all the recorded commands on the ecs, don't call it inside a loop over the entities
+
+		void flush(ENTITY_COMPONENT_SYSTEM &ecs)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			kills.clear();
+
+			// adds and removes in order, collect the kills
+
+			for(auto &command : commands)
+			{
+				if(command.type == CREATE || !ecs.alive(command.handle))
+				{
+					continue;
+				}
+
+				size_t id = ecs.slots[command.handle.index].dense;
+
+				if(command.type == KILL)
+				{
+					kills.push_back(id);
+				}
+				else if(command.type == ADD)
+				{
+					ecs.entity_list[id] |= command.bits;
+
+					ecs.attach_mask(id, command.bits);
+				}
+				else
+				{
+					ecs.entity_list[id] &= ~command.bits;
+
+					ecs.detach_mask(id, command.bits);
+				}
+			}
+
+			// all the kills at once
+
+			std::sort(kills.begin(), kills.end());
+
+			kills.erase(std::unique(kills.begin(), kills.end()), kills.end());
+
+			ecs.kill_sorted(kills);
+
+			// then the creates
+
+			size_t next = 0;
+
+			for(auto &command : commands)
+			{
+				if(command.type == CREATE)
+				{
+					ENTITY entity = ecs.create_entity_mask(command.bits);
+
+					if(creators[next])
+					{
+						creators[next](entity);
+					}
+
+					next++;
+				}
+			}
+
+			commands.clear();
+
+			creators.clear();
+		}
+	};
+
+
+
+	// entity functions
+
+
+
+	private:
+
+
+
+	// adds a new entity with the components in "bits"
+
+	constexpr ENTITY create_entity_mask(ENTITY_BITMASK_TYPE bits) noexcept
+	{
+		if ((size_t)(top + 1) >= entity_list.size())
+		{
+			grow();
+		}
+
+		temp_entity.id = ++top;
+
+		entity_list[top] = bits;
+
+		attach_mask(top, bits);
+
+		attach_slot();
+
+		return temp_entity;
+	}
+
+
+
+	public:
+
+
+
+	/*
+		adds a new entity to the ECS and returns it as an entity object
+		
+		lets you specify the ids of the components to be added to this entity as template arguments
+	*/
+
+	template<uint8_t... index_of_component> requires(
+		(0 <= index_of_component && index_of_component < sizeof...(component_types)) && ...
+	)
+
+	constexpr ENTITY create_entity() noexcept
+	{
+		// check for overflow
+
+		if (top >= entity_list.size() - 1)
+		{
+			// overflowing, increase capacity
+
+			grow();
+		}
+
+		temp_entity.id = ++top;
+
+		// setting entity bitmask
+
+		entity_list[top] = (((ENTITY_BITMASK_TYPE)1 << index_of_component) | ...);
+
+		(attach<index_of_component>(top), ...);
+
+		attach_slot();
+
+		return temp_entity;
+	}
+
+
+	/*
+		overloaded version of previous function
+		
+		it adds all available components to the new entity
+	*/
+
+	constexpr ENTITY create_entity() noexcept
+	{
+		// check for overflow
+
+		if (top >= entity_list.size() - 1)
+		{
+			// overflowing, increase capacity
+
+			grow();
+		}
+
+		// incrementing the top to push a new entity
+
+		temp_entity.id = ++top;
+
+		// setting entity bitmask
+
+		entity_list[top] = -1;
+
+		[&]<size_t... index>(std::index_sequence<index...>)
+		{
+			(attach<index>(top), ...);
+
+		}(std::index_sequence_for<component_types...>{});
+
+		attach_slot();
+		
+		return temp_entity;
+	}
+
+
+	/*
+		exchanges the given entity with the last entity before killing the last entity
+		this ensures a packed entity list, which provides better performance
+	*/
+
+	constexpr void kill_entity(ENTITY &entity) noexcept
+	{
+		// we don't need to check for top here this valid() function does that
+
+		if(entity.valid())
+		{
+			// killing an entity only if it's valid
+
+			uint32_t index = slot_of[entity.id];	// slot of this entity
+
+			// this entity will be replaced with the last entity
+
+			entity_list[entity.id] = entity_list[top];
+
+			// the last entity moves, so its slot must point to its new id
+
+			slot_of[entity.id] = slot_of[top];
+
+			slots[slot_of[entity.id]].dense = (uint32_t)entity.id;
+
+			// slot of this entity becomes free, with a new generation, so that its handles become stale
+
+			slots[index].generation++;
+
+			slots[index].dense = free_slot;
+
+			free_slot = index;
+
+			// components of this entity will be replaced with the components of last entity
+
+			std::apply([&](auto&&... args) {(move_component(args, top, entity.id), ...); }, component_tuple);
+
+			if(entity.id == (size_t)top)
+			{
+				forget_changes(top);
+			}
+			else
+			{
+				move_changes(top, entity.id);
+			}
 
 			// decrement top to pop out the last entity
 
@@ -618,6 +1983,19 @@ class bb::ENTITY_COMPONENT_SYSTEM
 	}
 
 
+	/*
+		kills the entity referred by the handle, if it's still alive
+	*/
+
+	constexpr void kill_entity(HANDLE handle) noexcept
+	{
+		if(alive(handle))
+		{
+			kill_entity(entity(handle));
+		}
+	}
+
+
 	/*
 		extend the entity_list and all of component_lists to hold some more
 		entities and their components
@@ -636,13 +2014,344 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 		size_t required_capacity = entity_count() + extra;
 
-		// allocating space for the entities
+		// allocating space for the entities, and their components, counting the reallocations
+
+		auto resize = [&](auto &storage)
+		{
+			size_t old_bytes = bytes_of(storage);
+
+			storage.resize(required_capacity);
+
+			reallocations += bytes_of(storage) != old_bytes;
+		};
 		
-		entity_list.resize(required_capacity);
+		resize(entity_list);
+
+		resize(slot_of);
+
+		std::apply([&](auto&&... args) {(resize(args), ...); }, component_tuple);
+
+		[&]<size_t... index>(std::index_sequence<index...>)
+		{
+			((is_tracked<index> ? changes[index].resize(required_capacity) : void()), ...);
+
+		}(std::index_sequence_for<component_types...>{});
+	}
+
+
+	struct MEMORY_STATS
+	{
+		size_t bytes;	// bytes allocated by the ECS, including the change sets and the kill lists
+
+		size_t reallocations;	// no. of times a vector was reallocated to grow
+
+		size_t capacity;	// no. of entities that can be stored without growing
+	};
+
+
+	// memory used by the ECS, see "Memory Used by the ECS" above
+
+	MEMORY_STATS memory_stats() const noexcept
+	{
+		size_t bytes = bytes_of(entity_list) + bytes_of(slot_of) + bytes_of(slots);
+
+		std::apply([&](auto&... args) {((bytes += bytes_of(args)), ...); }, component_tuple);
+
+		for(const auto &change_set : changes)
+		{
+			bytes += change_set.bytes();
+		}
+
+		bytes += bytes_of(deferred_kills) + bytes_of(kill_list) + bytes_of(moves);
+
+		for(const auto &kills : deferred_kills)
+		{
+			bytes += bytes_of(kills);
+		}
+
+		return {bytes, reallocations, entity_list.size()};
+	}
+
+
+
+	private:
+
+
+
+	// save and load, see "Saving and Loading" above
+
+	static constexpr uint32_t SAVE_MAGIC = 0x53434542;	// "BECS"
+
+	static constexpr uint32_t SAVE_VERSION = 1;	// increment it when the format changes
+
+
+	struct SAVE_HEADER
+	{
+		uint32_t magic, version;
+
+		uint32_t bitmask_size, components;
+
+		uint64_t entities, slots;
+
+		uint32_t free_slot, padding;
+	};
+
+
+	// sizes of the component types, to detect an ECS with different components
+
+	static constexpr std::array<uint32_t, sizeof...(component_types)> component_sizes = {
+		(uint32_t)sizeof(typename COMPONENT_STORAGE<component_types>::type::value_type)...
+	};
+
+
+	template<typename STORAGE>
+
+	static void save_component(BINARY_WRITER &writer, const STORAGE &storage, size_t count)
+	{
+		if constexpr (requires { storage.save(writer); })
+		{
+			storage.save(writer);
+		}
+		else
+		{
+			writer.align(8);
+
+			writer.write_array(storage.data(), count);
+		}
+	}
+
+
+	template<typename STORAGE>
+
+	void load_component(BINARY_READER &reader, STORAGE &storage, size_t count)
+	{
+		if constexpr (requires { storage.load(reader, count, count); })
+		{
+			storage.load(reader, entity_list.size(), count);
+		}
+		else
+		{
+			reader.align(8);
+
+			reader.read_array(storage.data(), count);
+		}
+	}
+
+
+
+	// checks that exactly the entities having the bit of a sparse component own it in the sparse set
+
+	template<uint8_t index_of_component>
+
+	bool owners_consistent() const
+	{
+		if constexpr (is_sparse<index_of_component>)
+		{
+			const auto &storage = std::get<index_of_component>(component_tuple);
+
+			for(size_t id = 0; id < entity_count(); id++)
+			{
+				if((bool)(entity_list[id] >> index_of_component & 1) != storage.contains(id))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+
+	/*
+		checks the loaded entities and slots, each entity has its own slot pointing back to it, and
+		the free slots form a list, ending with UINT32_MAX, that holds all the other slots once, and
+		the bitmasks agree with the owners of the sparse sets
+	*/
+
+	bool consistent() const
+	{
+		size_t count = entity_count();
+
+		bool owners = [&]<size_t... index>(std::index_sequence<index...>)
+		{
+			return (owners_consistent<index>() && ...);
 
-		// allocating space for their components
+		}(std::index_sequence_for<component_types...>{});
 
-		std::apply([&](auto&&... args) {((args.resize(required_capacity)), ...); }, component_tuple);
+		if(!owners)
+		{
+			return false;
+		}
+
+		std::vector<bool> used(slots.size(), false);
+
+		for(size_t id = 0; id < count; id++)
+		{
+			uint32_t index = slot_of[id];
+
+			if(index >= slots.size() || used[index] || slots[index].dense != id)
+			{
+				return false;
+			}
+
+			used[index] = true;
+		}
+
+		size_t free_count = 0;
+
+		for(uint32_t index = free_slot; index != UINT32_MAX; index = slots[index].dense)
+		{
+			if(index >= slots.size() || used[index])
+			{
+				return false;	// out of range, or a loop
+			}
+
+			used[index] = true;
+
+			free_count++;
+		}
+
+		return count + free_count == slots.size();
+	}
+
+
+
+	public:
+
+
+
+	// write the whole state of the ECS into the buffer (its old content is replaced)
+
+	void save(std::vector<char> &buffer) const
+	{
+		buffer.clear();
+
+		BINARY_WRITER writer(buffer);
+
+		size_t count = entity_count();
+
+		writer.write(SAVE_HEADER{SAVE_MAGIC, SAVE_VERSION, sizeof(ENTITY_BITMASK_TYPE), sizeof...(component_types), count, slots.size(), free_slot, 0});
+
+		writer.write_array(component_sizes.data(), component_sizes.size());
+
+		writer.align(8);
+
+		writer.write_array(entity_list.data(), count);
+
+		writer.align(8);
+
+		writer.write_array(slot_of.data(), count);
+
+		writer.align(8);
+
+		writer.write_array(slots.data(), slots.size());
+
+		std::apply([&](auto&... storage) {(save_component(writer, storage, count), ...); }, component_tuple);
+	}
+
+
+	// returns false if the stream can't be written
+
+	bool save(std::ostream &stream) const
+	{
+		std::vector<char> buffer;
+
+		save(buffer);
+
+		stream.write(buffer.data(), buffer.size());
+
+		return (bool)stream;
+	}
+
+
+	/*
+		replace the state of the ECS with the one saved in the memory, returns false (and leaves the
+		ECS empty) if the data is not valid, the memory is not used after load() returns
+	*/
+
+	bool load(const void *data, size_t size)
+	{
+		BINARY_READER reader(data, size);
+
+		SAVE_HEADER header{};
+
+		reader.read(header);
+
+		std::array<uint32_t, sizeof...(component_types)> sizes{};
+
+		reader.read_array(sizes.data(), sizes.size());
+
+		if(
+			!reader.ok() || header.magic != SAVE_MAGIC || header.version != SAVE_VERSION ||
+			header.bitmask_size != sizeof(ENTITY_BITMASK_TYPE) || header.components != sizeof...(component_types) ||
+			sizes != component_sizes || header.entities > header.slots || header.slots >= UINT32_MAX ||
+			header.entities > reader.remaining() ||
+			header.slots * sizeof(SLOT) > reader.remaining()
+		)
+		{
+			clear();
+
+			return false;
+		}
+
+		clear();
+
+		size_t count = header.entities;
+
+		reserve_extra(count);
+
+		top = (long long)count - 1;
+
+		slots.resize(header.slots);
+
+		free_slot = header.free_slot;
+
+		reader.align(8);
+
+		reader.read_array(entity_list.data(), count);
+
+		reader.align(8);
+
+		reader.read_array(slot_of.data(), count);
+
+		reader.align(8);
+
+		reader.read_array(slots.data(), slots.size());
+
+		std::apply([&](auto&... storage) {(load_component(reader, storage, count), ...); }, component_tuple);
+
+		if(!reader.ok() || !consistent())
+		{
+			clear();
+
+			return false;
+		}
+
+		// the whole state is new
+
+		[&]<size_t... index>(std::index_sequence<index...>)
+		{
+			((is_tracked<index> ? changes[index].set_all(count) : void()), ...);
+
+		}(std::index_sequence_for<component_types...>{});
+
+		return true;
+	}
+
+
+	bool load(const std::vector<char> &buffer)
+	{
+		return load(buffer.data(), buffer.size());
+	}
+
+
+	// reads the stream till its end
+
+	bool load(std::istream &stream)
+	{
+		std::vector<char> buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		return load(buffer.data(), buffer.size());
 	}
 
 
@@ -660,6 +2369,42 @@ class bb::ENTITY_COMPONENT_SYSTEM
 	}
 
 
+	/*
+		access the entity referred by a handle as an entity object
+
+		!!!! Caution: the handle is not checked, use alive() if it may be stale !!!!
+	*/
+
+	constexpr ENTITY& entity(HANDLE handle) noexcept
+	{
+		temp_entity.id = slots[handle.index].dense;
+
+		return temp_entity;
+	}
+
+
+	/*
+		stable handle of an entity, using the entity id
+
+		!!!! Caution: the "Entity Ids" are not checked !!!!
+	*/
+
+	constexpr HANDLE handle(size_t id) const noexcept
+	{
+		uint32_t index = slot_of[id];
+
+		return {index, slots[index].generation};
+	}
+
+
+	// is the entity referred by the handle still alive (not killed)
+
+	constexpr bool alive(HANDLE handle) const noexcept
+	{
+		return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+	}
+
+
 	constexpr size_t component_count() const noexcept
 	{
 		return sizeof... (component_types);
@@ -682,6 +2427,23 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 		entity_list.clear();
 
+		slots.clear();
+
+		slot_of.clear();
+
+		free_slot = UINT32_MAX;
+
+		deferred_kills.clear();
+
+		kill_list.clear();
+
+		moves.clear();
+
+		for(auto &change_set : changes)
+		{
+			change_set.release();
+		}
+
 		std::apply([&](auto&&... args) {((args.clear()), ...); }, component_tuple);
 	}
 
@@ -710,6 +2472,11 @@ class bb::ENTITY_COMPONENT_SYSTEM
 
 	If you want to change "RESERVE_EXTRA_ENTITIES", unfortunately you have to
 	use ENTITY_COMPONENT_SYSTEM<> template
+
+	To store the entities grouped by their components in chunks (archetypes) instead, put
+	ARCHETYPE<> before the component types (see archetype_component_system.h),
+
+	ECS<ARCHETYPE<>, int, double, float>::C8 ecs;
 */
 
 template<typename... component_types>
@@ -0,0 +1,341 @@
+#pragma once
+
+#include<vector>
+
+#include<utility>
+
+#include<type_traits>
+
+#include<cstddef>
+
+#include<cstdint>
+
+#include"../utility/default_init_allocator.h"	// vector components are not zero filled on resize
+
+#include"../utility/binary_stream.h"	// to save and load the ECS
+
+
+namespace bb
+{
+	template<typename T>
+
+	struct SPARSE;
+
+	template<typename T>
+
+	class SPARSE_SET;
+
+	template<typename T>
+
+	struct COMPONENT_STORAGE;
+}
+
+
+
+/*
+	Wrap a component type in SPARSE<> to store it in a sparse set instead of a vector in
+	ENTITY_COMPONENT_SYSTEM (see entity_component_system.h),
+
+	ECS<sf::Vertex, sf::Vector2f, SPARSE<double>>::C8 ecs;	// vectors for first two, sparse set for the last
+
+	a vector holds the component for every entity, even for those that don't have it, while a
+	sparse set holds it only for the entities that have it (its owners), packed together, so a
+	component only a few entities have (say, "burning" or "selected") costs memory only for them
+	and can be iterated over quickly.
+
+	entity.get<>(), add<>(), remove<>(), has<>() and ecs.each<>() work the same for sparse
+	components, add<>() and remove<>() are still O(1), ecs.component<>() returns the SPARSE_SET.
+
+	a component added to an entity (by create_entity() or add<>()) is set to its default value (T{}).
+
+	**********************************
+	Let me describe it's inner working
+	**********************************
+
+	entity_id    ->  0     1     2     3     4
+	sparse       : [NONE][ 1  ][NONE][ 0  ][NONE]	index of the component of each entity in dense
+
+	index        ->  0     1
+	owner        : [ 3  ][ 1  ]	entity id of each component
+	dense        : [ c3 ][ c1 ]	the components, packed
+
+	adding a component pushes it at the back of dense, removing one moves the last component in
+	its place, so dense stays packed, sparse and owner are updated accordingly, all in O(1).
+
+	when the ECS kills an entity, the last entity (top) takes its id, move_owner() updates the
+	sparse set for it, in O(1).
+
+	iterating over the owners:-
+
+	auto &burning = ecs.component<BURNING>();	// SPARSE_SET<double>
+
+	for(size_t i = 0; i < burning.size(); i++)
+	{
+		burning.data()[i] += dt;	// component of the entity burning.owners()[i]
+	}
+*/
+
+template<typename T>
+
+struct bb::SPARSE
+{
+	using type = T;
+};
+
+
+
+template<typename T>
+
+class bb::SPARSE_SET
+{
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	std::vector<uint32_t> sparse;	// index in dense of each entity, NONE if it doesn't have the component
+
+	std::vector<uint32_t> owner;	// entity id of each component in dense
+
+	std::vector<T> dense;	// the components, packed
+
+
+	public:
+
+
+	using value_type = T;
+
+
+	// make room for the entities with ids < entities
+
+	void resize(size_t entities)
+	{
+		sparse.resize(entities, NONE);
+	}
+
+
+	bool contains(size_t id) const noexcept
+	{
+		return id < sparse.size() && sparse[id] != NONE;
+	}
+
+
+	// give the component to an entity (if it doesn't have it yet), returns the component
+
+	T& insert(size_t id)
+	{
+		if(!contains(id))
+		{
+			sparse[id] = (uint32_t)dense.size();
+
+			owner.push_back((uint32_t)id);
+
+			dense.emplace_back();
+		}
+
+		return dense[sparse[id]];
+	}
+
+
+	// take the component away from an entity (if it has it), the last component takes its place
+
+	void erase(size_t id)
+	{
+		if(!contains(id))
+		{
+			return;
+		}
+
+		uint32_t index = sparse[id];
+
+		uint32_t last = (uint32_t)dense.size() - 1;
+
+		if(index != last)
+		{
+			dense[index] = std::move(dense[last]);
+
+			owner[index] = owner[last];
+
+			sparse[owner[index]] = index;
+		}
+
+		dense.pop_back();
+
+		owner.pop_back();
+
+		sparse[id] = NONE;
+	}
+
+
+	// entity "from" takes the id "to" (the entity with id "to" is being killed)
+
+	void move_owner(size_t from, size_t to)
+	{
+		erase(to);
+
+		if(contains(from))
+		{
+			uint32_t index = sparse[from];
+
+			sparse[to] = index;
+
+			owner[index] = (uint32_t)to;
+
+			sparse[from] = NONE;
+		}
+	}
+
+
+	/*
+		component of an entity
+
+		!!!! Caution: it doesn't check if the entity has the component !!!!
+	*/
+
+	T& operator[](size_t id) noexcept
+	{
+		return dense[sparse[id]];
+	}
+
+
+	const T& operator[](size_t id) const noexcept
+	{
+		return dense[sparse[id]];
+	}
+
+
+	// no. of entities having the component
+
+	size_t size() const noexcept
+	{
+		return dense.size();
+	}
+
+
+	// entity ids of the owners, owners()[i] owns data()[i]
+
+	const std::vector<uint32_t>& owners() const noexcept
+	{
+		return owner;
+	}
+
+
+	std::vector<T>& data() noexcept
+	{
+		return dense;
+	}
+
+
+	// bytes allocated by the sparse set
+
+	size_t bytes() const noexcept
+	{
+		return sizeof(uint32_t) * (sparse.capacity() + owner.capacity()) + sizeof(T) * dense.capacity();
+	}
+
+
+	// write the owners and their components, the ECS uses it to save itself
+
+	void save(BINARY_WRITER &writer) const
+	{
+		writer.write((uint64_t)dense.size());
+
+		writer.align(8);
+
+		writer.write_array(owner.data(), owner.size());
+
+		writer.align(8);
+
+		writer.write_array(dense.data(), dense.size());
+	}
+
+
+	/*
+		read what save() wrote, with room for the entities with ids < capacity, fails the reader if the
+		data is wrong, i.e., an owner isn't an alive entity (id >= entities) or owns two components
+	*/
+
+	void load(BINARY_READER &reader, size_t capacity, size_t entities)
+	{
+		uint64_t count = 0;
+
+		reader.read(count);
+
+		clear();
+
+		sparse.resize(capacity, NONE);
+
+		if(!reader.ok() || count > entities)
+		{
+			reader.fail();
+
+			return;
+		}
+
+		owner.resize(count);
+
+		dense.resize(count);
+
+		reader.align(8);
+
+		reader.read_array(owner.data(), owner.size());
+
+		reader.align(8);
+
+		reader.read_array(dense.data(), dense.size());
+
+		// rebuild the sparse array from the owners
+
+		for(uint32_t index = 0; index < count && reader.ok(); index++)
+		{
+			if(owner[index] >= entities || sparse[owner[index]] != NONE)
+			{
+				reader.fail();
+			}
+			else
+			{
+				sparse[owner[index]] = index;
+			}
+		}
+	}
+
+
+	void clear() noexcept
+	{
+		sparse.clear();
+
+		owner.clear();
+
+		dense.clear();
+	}
+};
+
+
+
+/*
+	storage of a component type in ENTITY_COMPONENT_SYSTEM, a vector by default (whose new elements
+	are default-initialized, not zero filled), a SPARSE_SET for SPARSE<T>
+*/
+
+template<typename T>
+
+struct bb::COMPONENT_STORAGE
+{
+	using type = std::vector<T, DEFAULT_INIT_ALLOCATOR<T>>;
+
+	static constexpr bool sparse = false;
+
+	static constexpr bool tracked = false;	// TRACKED<T>, see change_set.h
+};
+
+
+namespace bb
+{
+	template<typename T>
+
+	struct COMPONENT_STORAGE<SPARSE<T>>
+	{
+		using type = SPARSE_SET<T>;
+
+		static constexpr bool sparse = true;
+
+		static constexpr bool tracked = false;
+	};
+}
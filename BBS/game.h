@@ -36,19 +36,39 @@
 
 #include"timer/timer.h"	// general purpose asynchronous timer classes
 
+#include"timer/tween_manager.h"	// runs thousands of tweens from the update loop
+
 #include"entity_component_system/entity_component_system.h"	// general purpose entity component system
 
-#include"SFML_components/text_center_origin.h"	// center origin a sfml text
+#include"entity_component_system/archetype_component_system.h"	// entity component system with archetype storage
+
+#ifndef HEADLESS_GAME
+
+	#include"sfml_components/text_center_origin.h"	// center origin a sfml text
+
+	#include"sfml_components/rounded_rectangle_shape.h"	// sfml style rounded rectangle shape
+
+	#include"sfml_components/generate_sprite_vector.h"	// sfml style rounded rectangle shape
+
+	#include"system/window.h"
+
+	#include"system/input.h"
+
+#else
+
+	#ifndef NO_GAME_RENDER
+
+		#define NO_GAME_RENDER	// nothing is rendered in headless mode
 
-#include"SFML_components/rounded_rectangle_shape.h"	// sfml style rounded rectangle shape
+	#endif
 
-#include"SFML_components/generate_sprite_vector.h"	// sfml style rounded rectangle shape
+#endif
 
-#include"system/window.h"
+#ifdef _WIN32
 
-#include"system/input.h"
+	#include"system/file_management_for_windows.h"
 
-#include"system/file_management_for_windows.h"
+#endif
 
 
 namespace bb
@@ -148,16 +168,42 @@ namespace bb
 	Render() are declared by default i.e., one must define them, to use their default definition one must
 	define "NO_GAME_UPDATE" and "NO_GAME_RENDER" macros respectively.
 
-	Input(), Render_Thread_Init(), Clear(), Print() and Destroy() are usually not required to be redefined
-	but if one wants to redefine them, he or she must define "GAME_INPUT", "GAME_RENDER_THREAD_INIT",
-	"GAME_CLEAR", "GAME_PRINT", "GAME_DESTROY" macros respectively to disable or remove their default definition.
+	Input(), Input_Sync(), Render_Thread_Init(), Clear(), Print() and Destroy() are usually not required to be
+	redefined but if one wants to redefine them, he or she must define "GAME_INPUT", "GAME_INPUT_SYNC",
+	"GAME_RENDER_THREAD_INIT", "GAME_CLEAR", "GAME_PRINT", "GAME_DESTROY" macros respectively to disable or
+	remove their default definition.
 
-	**** This file only contains default definitions of Input(), Render_Thread_Init(), Clear(), Print() member
-	**** functions, default definitions of other member functions are provided in parent class
+	**** This file only contains default definitions of Input(), Input_Sync(), Render_Thread_Init(), Clear(),
+	**** Print() member functions, default definitions of other member functions are provided in parent class
 
 	Summary:
 
 	If you want to redefine only "Create(), Update() and Render()", you don't need to define any macro
+
+	Headless mode:
+
+	Define "HEADLESS_GAME" macro to run only the simulation, without any window (say, on a server or a
+	build machine without any display, to run simulated sessions for balancing or benchmarks).
+
+	In this mode bb::WINDOW and bb::INPUT are not created, the render loop is not started, Render() is
+	not declared (you don't need to define it) and the updates run back to back as fast as possible, each
+	Update() receives 1 / ups as dt (see start_headless() in game_loop.h). The engine clock (bb::CLOCK) is
+	stepped by the same dt after each update, so TIMER, DELAY_TIMER, TWEENER and the other timers run on
+	this virtual time too, and a session gives the same results however fast it runs (call
+	CLOCK.set_manual(0) in Create() to start each run from the same time). Define "HEADLESS_REALTIME" too
+	to run the updates in real time instead.
+
+	!!!! don't use bb::WINDOW, bb::INPUT or any asset that uses them in headless mode
+
+	Profiling:
+
+	Define "ENABLE_PROFILER" macro to record the time taken by each call to the member functions of
+	Game (Create(), Input(), Update(), Render() etc.), when the game ends the records are written to
+	"trace.json" (define "PROFILER_TRACE_FILE" as another file name to change it), open it in
+	chrome://tracing or https://ui.perfetto.dev. Use PROFILE_SCOPE("name") to profile your own code
+	too (see utility/profiler.h), without "ENABLE_PROFILER" it all costs nothing.
+
+	Functions to access windows AppData folder are available only on windows.
 */
 
 
@@ -167,6 +213,9 @@ class bb::Game : public bb::GAME_LOOP
 
 
 	void Input() override;
+
+
+	void Input_Sync() override;
 	
 
 	#ifndef NO_GAME_UPDATE
@@ -208,12 +257,20 @@ class bb::Game : public bb::GAME_LOOP
 			starting the render thread
 		*/
 
-		WINDOW.setActive(false);
+		#ifndef HEADLESS_GAME
+
+			WINDOW.setActive(false);
+
+		#endif
 	}
 
 	~Game()
 	{
-		WINDOW.close();
+		#ifndef HEADLESS_GAME
+
+			WINDOW.close();
+
+		#endif
 	}
 } bb::MY_GAME;	// object representing the core of this this game
 
@@ -223,11 +280,82 @@ class bb::Game : public bb::GAME_LOOP
 */
 
 
+#ifdef HEADLESS_GAME
+
+	// nothing to scan or draw without a window
+
+	#ifndef GAME_INPUT
+
+		inline void bb::Game::Input()
+		{}
+
+		#define GAME_INPUT
+
+	#endif
+
+	#ifndef GAME_INPUT_SYNC
+
+		inline void bb::Game::Input_Sync()
+		{}
+
+		#define GAME_INPUT_SYNC
+
+	#endif
+
+	#ifndef GAME_RENDER_THREAD_INIT
+
+		inline void bb::Game::Render_Thread_Init()
+		{}
+
+		#define GAME_RENDER_THREAD_INIT
+
+	#endif
+
+	#ifndef GAME_CLEAR
+
+		inline void bb::Game::Clear()
+		{}
+
+		#define GAME_CLEAR
+
+	#endif
+
+	#ifndef GAME_PRINT
+
+		inline void bb::Game::Print()
+		{}
+
+		#define GAME_PRINT
+
+	#endif
+
+#endif
+
+
 #ifndef GAME_INPUT
 
 	inline void bb::Game::Input()
 	{
-		INPUT.scan();
+		// in PIPELINE mode Update() runs on another thread, so the events are only polled here
+
+		if(get_sync() == PIPELINE)
+		{
+			INPUT.poll();
+		}
+		else
+		{
+			INPUT.scan();
+		}
+	}
+
+#endif
+
+
+#ifndef GAME_INPUT_SYNC
+
+	inline void bb::Game::Input_Sync()
+	{
+		INPUT.sync();	// process the events polled by Input(), in PIPELINE mode
 	}
 
 #endif
@@ -286,7 +414,31 @@ int main(int arg_count, char *arg[])
 
 	bb::arg = arg;
 
-	bb::MY_GAME.start_game();
+	#if !defined(HEADLESS_GAME)
+
+		bb::MY_GAME.start_game();
+
+	#elif defined(HEADLESS_REALTIME)
+
+		bb::MY_GAME.start_headless(120, true);
+
+	#else
+
+		bb::MY_GAME.start_headless();
+
+	#endif
+
+	#ifdef ENABLE_PROFILER
+
+		#ifndef PROFILER_TRACE_FILE
+
+			#define PROFILER_TRACE_FILE "trace.json"
+
+		#endif
+
+		bb::PROFILER.write_trace(PROFILER_TRACE_FILE);
+
+	#endif
 
 	return bb::return_value;
 }
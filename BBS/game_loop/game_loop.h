@@ -6,8 +6,28 @@
 
 #include<atomic>
 
+#include<chrono>
+
+#include<algorithm>
+
+#include<cmath>
+
+#include"../utility/clock.h"	// the clock of the whole game engine
+
 #include"../utility/fps_control.h"	// to coltrol the fps properly as it changes continuously making the graphics bad
 
+#include"../utility/frame_stats.h"	// to keep per-frame timing samples
+
+#include"snapshot.h"	// to hand over the game state to render loop in DECOUPLED mode
+
+#include"../utility/interpolated.h"	// to interpolate the states between two updates
+
+#include"../job_system/job_system.h"	// thread pool to split the work of a frame among the cores
+
+#include"../utility/spsc_queue.h"	// to pass the frames between the stages in PIPELINE mode
+
+#include"../utility/profiler.h"	// to profile the calls of the game functions (only if ENABLE_PROFILER is defined)
+
 
 
 #define SUCCESS 0
@@ -47,6 +67,13 @@ namespace bb
         It contains definition of the input system i.e., basically the
         functions or macros used for the I/P system
 
+        => void Input_Sync()
+
+        Used only in PIPELINE mode, where Input() runs on the main thread
+        while Update() runs on the update thread one frame behind, it's
+        called before each Update() to take over the input captured by
+        Input() (see set_sync())
+
         => bool Update(double passed_time)
 
         It contains the game logic processing system, it takes an argument
@@ -87,53 +114,493 @@ namespace bb
 
 class bb::GAME_LOOP
 {
+	public:
+
+	// how the update and render loops are synchronized, see set_sync()
+
+	enum SYNC { LOCKSTEP, DECOUPLED, PIPELINE };
+
+	private:
+
+	// a frame passing through the stages of PIPELINE mode
+
+	struct FRAME_TOKEN
+	{
+		double time;	// engine clock time when the input of this frame was taken
+
+		double leftover;	// time left in the update accumulator after the updates of this frame
+
+		std::chrono::steady_clock::time_point input_stamp;	// real time of the input, to measure latency
+	};
+
 	FPS_CONTROL FRAME_RATE_STABILIZER;
 
+	FPS_CONTROL UPDATE_RATE_STABILIZER;	// paces the update loop in DECOUPLED mode
+
+	SYNC sync = LOCKSTEP;
+
+	// headless => no render loop, realtime => updates run in real time, else as fast as possible
+
+	bool headless = false, realtime = false;
+
 	std::atomic_bool loop_continue, lock;
 
-	double udt, ut_accumulator;
+	/*
+		update interval, written by the update loop in adaptive mode, read by the render loop for alpha
+		(and by get_ups() from any thread), so it's atomic, relaxed is enough as it's a single value
+	*/
+
+	std::atomic<double> udt;
+
+	double ut_accumulator;
+
+	double target_udt;	// update interval set by set_ups(), udt may differ from it in adaptive mode
+
+	size_t max_steps = 0;	// max no. of updates in one iteration of update loop, 0 => no limit
+
+	bool adaptive_ups = false;
+
+	double max_udt;	// update interval at the lowest ups allowed in adaptive mode
+
+	double tick_cost = 0;	// running average of the time taken by one Input() - Update() pair
+
+	std::atomic<double> dropped_time = 0;	// simulation time thrown away to avoid the spiral of death
 	
 	std::atomic<double> fps;
 
+	std::atomic<double> cpu_saved;	// cpu time saved by the frame pacer in the last frame
+
+	std::atomic<double> alpha;	// position of the current frame between the last two updates [0 - 1]
+
+	// in DECOUPLED mode, leftover in the accumulator and the time (in seconds) when it's left
+
+	std::atomic<double> ut_leftover, ut_stamp;
+
+	FRAME_STATS<> frame_stats;	// per-frame timing samples, pushed by the render loop
+
+	JOB_SYSTEM job_system;	// workers start only when the first job is submitted
+
+	/*
+		stats of the last iteration of update loop, handed over to the render loop with the lock
+		(in DECOUPLED mode the render loop reads whatever is the latest)
+	*/
+
+	std::atomic<double> update_wait, update_time, update_ticks;
+
+	std::atomic<std::chrono::steady_clock::time_point> input_stamp;	// real time of the last Input()
+
+	/*
+		PIPELINE mode, input stage -> input_queue -> update stage -> update_queue -> render stage,
+		only one frame can wait in each queue, so each stage runs at most one frame ahead of
+		the next one
+	*/
+
+	SPSC_QUEUE<FRAME_TOKEN, 1> input_queue, update_queue;
+
+	/*
+		seconds passed since a time point, used only to measure the cost of the loops, so it
+		reads the real time, the game time is read from the engine clock (see clock.h)
+	*/
+
+	static double elapsed(std::chrono::steady_clock::time_point since)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+	}
+
 	/*
 		main game loop systems
 	*/
 
+	/*
+		the functions of the game are called through these, so that each call is profiled
+		when ENABLE_PROFILER is defined (see profiler.h), else they are just the calls
+	*/
+
+	bool call_create()
+	{
+		PROFILE_SCOPE("Create");
+
+		return Create();
+	}
+
+	void call_input()
+	{
+		PROFILE_SCOPE("Input");
+
+		Input();
+	}
+
+	void call_input_sync()
+	{
+		PROFILE_SCOPE("Input_Sync");
+
+		Input_Sync();
+	}
+
+	bool call_update(double dt)
+	{
+		PROFILE_SCOPE("Update");
+
+		return Update(dt);
+	}
+
+	void call_render_thread_init()
+	{
+		PROFILE_SCOPE("Render_Thread_Init");
+
+		Render_Thread_Init();
+	}
+
+	void call_clear()
+	{
+		PROFILE_SCOPE("Clear");
+
+		Clear();
+	}
+
+	void call_render()
+	{
+		PROFILE_SCOPE("Render");
+
+		Render();
+	}
+
+	void call_print()
+	{
+		PROFILE_SCOPE("Print");
+
+		Print();
+	}
+
+	bool call_destroy()
+	{
+		PROFILE_SCOPE("Destroy");
+
+		return Destroy();
+	}
+
+	/*
+		wait for a free element at the back of a pipeline queue (or a frame at the front), returns
+		nullptr if the game loop stops while waiting
+	*/
+
+	FRAME_TOKEN* wait_back(SPSC_QUEUE<FRAME_TOKEN, 1> &queue)
+	{
+		while(true)
+		{
+			auto version = queue.version();
+
+			if(auto token = queue.back())
+			{
+				return token;
+			}
+
+			if(!loop_continue)
+			{
+				return nullptr;
+			}
+
+			queue.wait(version);
+		}
+	}
+
+	FRAME_TOKEN* wait_front(SPSC_QUEUE<FRAME_TOKEN, 1> &queue)
+	{
+		while(true)
+		{
+			auto version = queue.version();
+
+			if(auto token = queue.front())
+			{
+				return token;
+			}
+
+			if(!loop_continue)
+			{
+				return nullptr;
+			}
+
+			queue.wait(version);
+		}
+	}
+
+	/*
+		run Input() - Update() pairs for all the complete update intervals in the accumulator,
+		in PIPELINE mode Input() is replaced by Input_Sync(), as the input is taken by the input
+		stage
+	*/
+
+	void update_ticks_run(bool pipelined = false)
+	{
+		auto clk_start = std::chrono::steady_clock::now();
+
+		double ticks = 0;
+
+		double dt = udt.load(std::memory_order_relaxed);	// only this thread changes it, in adapt_ups() below
+
+		while(ut_accumulator > dt)
+		{
+			if(max_steps && ticks >= max_steps)
+			{
+				/*
+					the updates can't keep up with the time, running all of them would take even
+					more time and the game would fall behind further in each iteration (spiral of
+					death), so we throw away the extra time, only the fraction of an update interval
+					is kept for interpolation
+				*/
+
+				double keep = std::fmod(ut_accumulator, dt);
+
+				dropped_time = dropped_time + (ut_accumulator - keep);
+
+				ut_accumulator = keep;
+
+				break;
+			}
+
+			if(pipelined)
+			{
+				call_input_sync();
+			}
+			else
+			{
+				call_input();
+
+				input_stamp = std::chrono::steady_clock::now();
+			}
+
+			if(call_update(dt) == STOP_GAME_LOOP)
+			{
+				loop_continue = false;	// stop the update and render loop
+			}
+
+			ut_accumulator -= dt;
+
+			ticks++;
+		}
+
+		update_ticks = ticks;
+
+		update_time = elapsed(clk_start);
+
+		if(adaptive_ups && ticks > 0)
+		{
+			adapt_ups(update_time / ticks);
+		}
+
+		ut_leftover = ut_accumulator;
+
+		ut_stamp = CLOCK.seconds();
+	}
+
+	/*
+		adaptive ups: if the updates take too large a share of the time, we lower the ups
+		(update interval is increased by 25%, till the lowest ups allowed) and when they
+		take a small share again, ups is raised back till the ups set by set_ups()
+	*/
+
+	void adapt_ups(double cost)
+	{
+		constexpr double weight = 0.1;	// weight of the latest cost in the running average
+
+		constexpr double high_load = 0.75, low_load = 0.375;	// share of time spent updating
+
+		tick_cost += weight * (cost - tick_cost);
+
+		double dt = udt.load(std::memory_order_relaxed);
+
+		double load = tick_cost / dt;
+
+		if(load > high_load && dt < max_udt)
+		{
+			udt.store(std::min(dt * 1.25, max_udt), std::memory_order_relaxed);
+		}
+		else if(load < low_load && dt > target_udt)
+		{
+			udt.store(std::max(dt / 1.25, target_udt), std::memory_order_relaxed);
+		}
+	}
+
+	/*
+		update stage of PIPELINE mode (runs on its own thread), updates the game till the time
+		of each frame received from the input stage and passes the frame on to the render stage
+	*/
+
+	void pipeline_update_loop()
+	{
+		PROFILE_THREAD("update");
+
+		double last_time = CLOCK.seconds();
+
+		do{
+			auto clk_wait = std::chrono::steady_clock::now();
+
+			FRAME_TOKEN *token = wait_front(input_queue);
+
+			if(!token)
+			{
+				break;
+			}
+
+			FRAME_TOKEN frame = *token;
+
+			input_queue.pop();
+
+			double wait = elapsed(clk_wait);
+
+			// the game time moves forward by the time passed between the inputs of two frames
+
+			ut_accumulator += frame.time - last_time;
+
+			last_time = frame.time;
+
+			update_ticks_run(true);
+
+			frame.leftover = ut_accumulator;
+
+			clk_wait = std::chrono::steady_clock::now();
+
+			if(!(token = wait_back(update_queue)))
+			{
+				break;
+			}
+
+			*token = frame;
+
+			update_wait = wait + elapsed(clk_wait);
+
+			update_queue.push();
+
+		}while(loop_continue);
+
+		// wake up the other stages, in case they are waiting for this one
+
+		input_queue.interrupt();
+
+		update_queue.interrupt();
+	}
+
 	/*
 		render loop
 	*/
 
 	void render_loop()
 	{
-		Render_Thread_Init();
+		PROFILE_THREAD("render");
+
+		call_render_thread_init();
 
 		FRAME_RATE_STABILIZER.initialize();	// run with stabilized fps
 
+		FRAME_STATS<>::SAMPLE sample{};
+
+		FRAME_TOKEN frame{};
+
 		do{
 			// >>>> graphics rendering system
 
 			{
-				// waiting for render to be unlocked
+				auto clk_wait = std::chrono::steady_clock::now();
+
+				// waiting for render to be unlocked (in DECOUPLED mode render never waits)
+
+				if(sync == LOCKSTEP)
+				{
+					lock.wait(false);
+				}
+				else if(sync == PIPELINE)
+				{
+					// waiting for the update stage to pass a frame
 
-				lock.wait(false);
+					FRAME_TOKEN *token = wait_front(update_queue);
+
+					if(!token)
+					{
+						break;
+					}
+
+					frame = *token;
+
+					update_queue.pop();
+				}
+
+				auto clk_start = std::chrono::steady_clock::now();
+
+				sample[FRAME_STATS<>::RENDER_WAIT] = std::chrono::duration<double>(clk_start - clk_wait).count();
+
+				// update loop has just finished its iteration, so its stats are ready
+
+				sample[FRAME_STATS<>::UPDATE_WAIT] = update_wait;
+
+				sample[FRAME_STATS<>::UPDATE_TIME] = update_time;
+
+				sample[FRAME_STATS<>::UPDATE_TICKS] = update_ticks;
 
 				fps = 1 / FRAME_RATE_STABILIZER.dt;
 
-				Clear();  // to clear the default frame or canvas
+				/*
+					the leftover time in the accumulator is the time the last update is behind
+					this frame, in DECOUPLED mode the time passed since the last update is added
+				*/
+
+				double interval = udt.load(std::memory_order_relaxed);
 
-				Render();    // to rander or draw on the default frame or canvas
+				if(sync == LOCKSTEP)
+				{
+					alpha = std::min(ut_accumulator / interval, 1.0);
+				}
+				else if(sync == PIPELINE)
+				{
+					alpha = std::min(frame.leftover / interval, 1.0);
+				}
+				else
+				{
+					double now = CLOCK.seconds();
+
+					alpha = std::min((ut_leftover + now - ut_stamp) / interval, 1.0);
+				}
+
+				// the input this frame shows
+
+				if(sync != PIPELINE)
+				{
+					frame.input_stamp = input_stamp;
+				}
+
+				call_clear();  // to clear the default frame or canvas
+
+				call_render();    // to rander or draw on the default frame or canvas
 
-				ut_accumulator += FRAME_RATE_STABILIZER.dt;
+				sample[FRAME_STATS<>::RENDER_TIME] = elapsed(clk_start);
 
-				lock = false;	// unlock the update
+				if(sync == LOCKSTEP)
+				{
+					ut_accumulator += FRAME_RATE_STABILIZER.dt;
+
+					lock = false;	// unlock the update
 
-				lock.notify_all();
+					lock.notify_all();
+				}
 			}
 
-			Print();  // to print the default frame or canvas on screen
+			auto clk_print = std::chrono::steady_clock::now();
+
+			call_print();  // to print the default frame or canvas on screen
+
+			sample[FRAME_STATS<>::RENDER_TIME] += elapsed(clk_print);
+
+			sample[FRAME_STATS<>::LATENCY] = elapsed(frame.input_stamp);
 
 			FRAME_RATE_STABILIZER.put_delay();	// dynamic delay to stabilize the fps
 
+			cpu_saved = FRAME_RATE_STABILIZER.saved;
+
+			sample[FRAME_STATS<>::FRAME_TIME] = FRAME_RATE_STABILIZER.dt;
+
+			sample[FRAME_STATS<>::SLACK] = FRAME_RATE_STABILIZER.slack;
+
+			frame_stats.push(sample);
+
 		}while(loop_continue);
 	}
 
@@ -141,18 +608,34 @@ class bb::GAME_LOOP
 	{
 		fps = 0;
 
+		cpu_saved = 0;
+
+		alpha = 0;
+
 		ut_accumulator = 0;	// keeps time for update
 
+		ut_leftover = 0;
+
+		ut_stamp = CLOCK.seconds();
+
 		lock = true;	// true => render, false => update
 
+		update_wait = update_time = update_ticks = 0;
+
+		input_stamp = std::chrono::steady_clock::now();
+
+		frame_stats.clear();
+
 		/*
 			to initialize game i.e. to create the initial state of
 			the game before entering the game loop
 		*/
 
-		if(Create() != SUCCESS)
+		PROFILE_THREAD("main");
+
+		if(call_create() != SUCCESS)
 		{
-			Destroy();	// if we fail to initialize the game then we must destroy it before returning
+			call_destroy();	// if we fail to initialize the game then we must destroy it before returning
 
 			return;
 		}
@@ -161,31 +644,112 @@ class bb::GAME_LOOP
 		{
 			loop_continue = true;
 
-			// start render loop
+			input_queue.clear();
+
+			update_queue.clear();
 
-			std::thread render_thread(&GAME_LOOP::render_loop, this);
+			// start render loop (not in headless mode)
+
+			std::thread render_thread;
+
+			if(!headless)
+			{
+				render_thread = std::thread(&GAME_LOOP::render_loop, this);
+			}
 
 			// start update loop
 
-			do{
+			if(headless && !realtime)
+			{
+				/*
+					no render loop and no real time, each iteration runs one update, time passes
+					by exactly one update interval in each update, no matter how long it takes,
+					the engine clock is in MANUAL mode (see start_headless()) and is stepped by the
+					same interval after each update, so the timers (TIMER, TWEENER...) follow the
+					same virtual time as the dt of Update()
+				*/
+
+				update_wait = 0;
+
+				do{
+					call_input();
+
+					double dt = udt.load(std::memory_order_relaxed);
+
+					if(call_update(dt) == STOP_GAME_LOOP)
+					{
+						loop_continue = false;	// stop the update loop
+					}
+
+					CLOCK.step(dt);
+
+				}while(loop_continue);
+			}
+			else if(headless || sync == DECOUPLED)
+			{
+				/*
+					the update loop keeps its own time and never waits for the render loop,
+					so a slow frame doesn't delay the updates and vice versa
+				*/
+
+				UPDATE_RATE_STABILIZER.initialize();
+
+				update_wait = 0;
+
+				do{
+					ut_accumulator += UPDATE_RATE_STABILIZER.dt;
+
+					update_ticks_run();
+
+					UPDATE_RATE_STABILIZER.set_interval(udt.load(std::memory_order_relaxed));
+
+					UPDATE_RATE_STABILIZER.put_delay();	// wait for the next update interval
+
+				}while(loop_continue);
+			}
+			else if(sync == PIPELINE)
+			{
+				/*
+					this thread is the input stage, it takes the input of a frame as soon as
+					the update stage is ready to receive it, the updates of the previous frame
+					and the render of the one before it run at the same time on other threads
+				*/
+
+				std::thread update_thread(&GAME_LOOP::pipeline_update_loop, this);
+
+				do{
+					FRAME_TOKEN *token = wait_back(input_queue);
+
+					if(!token)
+					{
+						break;
+					}
+
+					call_input();
+
+					token->time = CLOCK.seconds();
+
+					token->input_stamp = std::chrono::steady_clock::now();
+
+					input_queue.push();
+
+				}while(loop_continue);
+
+				update_thread.join();
+			}
+			else do{
                 // >>>> input and processing system
                 
 				{
+					auto clk_wait = std::chrono::steady_clock::now();
+
 					// waiting for update to be unlocked
 
 					lock.wait(true);
 
-					while(ut_accumulator > udt)
-					{
-						Input();
+					update_wait = elapsed(clk_wait);
 
-						if(Update(udt) == STOP_GAME_LOOP)
-						{
-							loop_continue = false;	// stop the update and render loop
-						}
-
-						ut_accumulator -= udt;
-					}
+					update_ticks_run();
 
 					lock = true;	// unlock the render
 
@@ -201,7 +765,7 @@ class bb::GAME_LOOP
 				render_thread.join();
 			}
 
-			if(Destroy() == SUCCESS)
+			if(call_destroy() == SUCCESS)
 				break;
 		}
 	}
@@ -219,6 +783,9 @@ class bb::GAME_LOOP
 	virtual void Input()
 	{}
 
+	virtual void Input_Sync()
+	{}
+
 	virtual bool Update(double dt)
 	{
 		return !STOP_GAME_LOOP;
@@ -245,11 +812,32 @@ class bb::GAME_LOOP
 
 	public:
 
+		/*
+			the thread pool of the game, use it to split heavy work (say, updating lots of
+			particles) among all the cpu cores, see job_system.h
+		*/
+
+		JOB_SYSTEM& jobs()
+		{
+			return job_system;
+		}
+
 		double get_fps()
     	{
        		return fps;
 		}
 
+		/*
+			position of the frame being rendered between the last two updates, 0 -> previous
+			update, 1 -> last update, call it from Render() to interpolate the states (see
+			interpolated.h)
+		*/
+
+		double get_alpha()
+		{
+			return alpha;
+		}
+
 		void set_fps(double target_fps = 30)
     	{
        		FRAME_RATE_STABILIZER.set(target_fps);
@@ -257,7 +845,131 @@ class bb::GAME_LOOP
 
 		void set_ups(double target_ups = 120)
     	{
-			udt = 1 / (target_ups);
+			target_udt = 1 / (target_ups);
+
+			udt.store(target_udt, std::memory_order_relaxed);
+		}
+
+		// current ups, differs from the one set by set_ups() only in adaptive mode
+
+		double get_ups()
+		{
+			return 1 / udt.load(std::memory_order_relaxed);
+		}
+
+		/*
+			limit the no. of Update() calls in one iteration of the update loop, if more updates
+			are due, the extra time is dropped, so the game slows down for a while instead of
+			falling further and further behind (spiral of death), 0 means no limit (default)
+		*/
+
+		void set_max_steps(size_t steps = 0)
+		{
+			max_steps = steps;
+		}
+
+		/*
+			in adaptive mode, if the updates take more than 75% of the time, ups is lowered
+			step by step (not below min_ups), when they take less than 37.5% ups is raised back
+			step by step, till the ups set by set_ups()
+
+			Update() receives the current update interval as dt, so a game using dt keeps
+			running at the same speed, only the precision changes
+		*/
+
+		void set_adaptive_ups(bool enable = true, double min_ups = 30)
+		{
+			adaptive_ups = enable;
+
+			max_udt = 1 / min_ups;
+
+			if(!enable)
+			{
+				udt.store(target_udt, std::memory_order_relaxed);
+			}
+		}
+
+		// total simulation time (in seconds) dropped by set_max_steps() limit
+
+		double get_dropped_time()
+		{
+			return dropped_time;
+		}
+
+		/*
+			select how the render loop waits for the next frame
+
+			FPS_CONTROL::SPIN (default) busy waits, FPS_CONTROL::HYBRID sleeps through most
+			of the wait and spins only at the end, see fps_control.h for more details,
+			it can be called at any time, from any thread
+		*/
+
+		void set_pacing(FPS_CONTROL::PACING mode)
+		{
+			FRAME_RATE_STABILIZER.set_pacing(mode);
+
+			UPDATE_RATE_STABILIZER.set_pacing(mode);
+		}
+
+		/*
+			select how the update and render loops are synchronized, call it before starting
+			the game loop or from Create()
+
+			LOCKSTEP (default), the loops take turns, render waits for update and update waits
+			for render, so they can safely share the game state.
+
+			DECOUPLED, both loops run at the same time, each on its own clock, so a slow Update()
+			doesn't delay a frame and a slow frame doesn't delay Update(), but the game state
+			must be handed over to Render() through a SNAPSHOT (see snapshot.h)
+
+			PIPELINE, three stages, each on its own thread and each working on a different frame,
+			Input() (main thread) takes the input of frame n + 2, Update() runs the updates of frame
+			n + 1 and Render() - Print() draw frame n, so a frame takes about as long as the slowest
+			stage instead of the sum of all of them. the price is latency, the input shows up on the
+			screen about two frames later. as Input() and Update() run on different threads, Input()
+			must only capture the input and Input_Sync(), called before each Update(), must take it
+			over (the default Input() and Input_Sync() of game.h do it with INPUT.poll() and
+			INPUT.sync()), the game state is handed over to Render() through a SNAPSHOT, like in
+			DECOUPLED mode.
+
+			compare get_frame_report(300, FRAME_STATS<>::LATENCY) in each mode to choose between them.
+		*/
+
+		void set_sync(SYNC mode)
+		{
+			sync = mode;
+		}
+
+		SYNC get_sync()
+		{
+			return sync;
+		}
+
+		// cpu time (in seconds) the render thread slept instead of spinning in the last frame
+
+		double get_cpu_saved()
+		{
+			return cpu_saved;
+		}
+
+		/*
+			p50, p95, p99, max and no. of hitches of a field (frame time by default) over the
+			last "window" frames, see frame_stats.h for the available fields
+
+			a sample longer than hitch_limit (in seconds) counts as a hitch, by default it's
+			1.5 times the target frame interval
+
+			it's cheap enough to be called from anywhere, any time, even in release builds
+		*/
+
+		FRAME_STATS<>::REPORT get_frame_report(size_t window = 300, FRAME_STATS<>::FIELD field = FRAME_STATS<>::FRAME_TIME, double hitch_limit = 0)
+		{
+			if(hitch_limit <= 0)
+			{
+				hitch_limit = 1.5 * FRAME_RATE_STABILIZER.get_interval();
+			}
+
+			return frame_stats.report(field, window, hitch_limit);
 		}
 
 		// call it from the constructor of the game object to start the game
@@ -268,7 +980,48 @@ class bb::GAME_LOOP
 
 			set_ups(target_ups);
 
+			headless = false;
+
+			game_loop();
+		}
+
+		/*
+			start the game without the render loop, Clear(), Render(), Print() and
+			Render_Thread_Init() are never called, so it needs no window or display
+
+			realtime = false => updates run back to back as fast as possible, each Update()
+			receives 1 / target_ups as dt, so the game runs on a virtual clock that's
+			independent of how long an update takes, the engine clock CLOCK is put in MANUAL
+			mode and stepped by dt after each update, so the timers follow the same virtual
+			time (the mode it had before is restored when the game ends), call CLOCK.set_manual(0)
+			in Create() to start from the same time in each run
+
+			realtime = true => updates run at target_ups in real time, like a game server
+		*/
+
+		void start_headless(double target_ups = 120, bool realtime = false)
+		{
+			set_ups(target_ups);
+
+			headless = true;
+
+			this->realtime = realtime;
+
+			double scale = CLOCK.get_scale();	// mode of the clock, restored at the end
+
+			bool stepped = !realtime && scale != 0;	// the clock is stepped by the update loop
+
+			if(stepped)
+			{
+				CLOCK.set_manual();	// before Create(), so no real time passes in the game
+			}
+
 			game_loop();
+
+			if(stepped)
+			{
+				CLOCK.set_scale(scale);
+			}
 		}
 };
 
@@ -301,6 +1054,61 @@ class bb::GAME_LOOP
 	respectively. you can also set fps and ups by directly calling set_fps() and set_ups().
 	You can also access the real fps with get_fps().
 
+	By default the render loop busy waits for the next frame, keeping a cpu core busy, call
+	set_pacing(FPS_CONTROL::HYBRID) to let it sleep through most of the wait, get_cpu_saved()
+	tells how much cpu time was saved in the last frame.
+
+	By default update and render loops take turns (LOCKSTEP), they never actually run at the
+	same time. call set_sync(GAME_LOOP::DECOUPLED) to let them run in parallel, in this mode
+	Update() must publish the state to be rendered through a SNAPSHOT and Render() must draw
+	only what it reads from the SNAPSHOT.
+
+	example,
+
+	SNAPSHOT<std::vector<sf::Vertex>> particles;
+
+	Update(): particles.write() = current_particles; particles.publish();
+
+	Render(): const auto &state = particles.read(); WINDOW.draw(state.data(), state.size(), sf::Points);
+
+	!!!! call read() once per frame and keep the reference, each call may switch to a newer state
+
+	Update() runs at a fixed rate and Render() at another, so a frame usually falls in between
+	two updates, get_alpha() gives its position between the last two updates [0 - 1], use
+	it with INTERPOLATED<T> (see interpolated.h) to render the states interpolated between
+	the last two updates, this makes the motion smooth even at a low ups.
+
+	If Update() takes longer than the update interval, the updates fall behind and each
+	iteration of the update loop has to run more updates than the previous (spiral of death),
+	to prevent it, limit the no. of updates in an iteration with set_max_steps(), the extra
+	time is dropped (get_dropped_time() tells how much), and/or let the game lower the ups
+	while the updates are too slow with set_adaptive_ups(), get_ups() gives the current ups.
+
+	To run only the simulation (say, on a server or for benchmarks on a machine without any
+	display), start the game with start_headless() instead of start_game(), the render loop
+	is not started and the updates run back to back as fast as possible (or in real time)
+
+	All the game time is read from the engine clock CLOCK (see clock.h), it can be slowed down,
+	sped up or stepped manually, in its MANUAL mode the game runs as fast as possible and
+	produces the same results in each run.
+
+	Update() runs on a single thread, to use the other cpu cores, split the heavy work into jobs
+	and run them on the thread pool of the game, jobs(), with parallel_for() or a JOB_GRAPH
+	(see job_system.h).
+
+	To see where the time of each frame goes, define ENABLE_PROFILER before including the engine,
+	each call to the functions of the game is recorded and PROFILER.write_trace() writes them as a
+	Chrome trace (see profiler.h).
+
+	get_fps() gives only the fps of the last frame, to find hitches use get_frame_report(),
+	it gives the percentiles (p50, p95, p99, max) of the frame time (or render time, update
+	time, time spent waiting etc.) over last few frames and the no. of hitches among them.
+
+	When Update() and Render() together take longer than a frame (say, on a high refresh rate
+	display), call set_sync(GAME_LOOP::PIPELINE) to run input, update and render as three
+	stages of a pipeline, each on a different frame, at the cost of a couple of frames of latency,
+	the LATENCY field of get_frame_report() tells how much (input to screen) in any mode.
+
 	Finally you have to declare a global object of this main game class to start the game.
 
 	Name of main game class or its object is not fixed, name them as you wish.
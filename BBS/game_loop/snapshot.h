@@ -0,0 +1,104 @@
+#pragma once
+
+#include<array>
+
+#include<atomic>
+
+#include<cstdint>
+
+
+namespace bb
+{
+	template<typename T>
+
+	class SNAPSHOT;
+}
+
+
+/*
+	this class lets the update loop hand over the game state to the render loop without
+	any lock, so that both of them can run at the same time (see DECOUPLED mode of GAME_LOOP)
+
+	the update loop writes the state in a "back" buffer and publishes it, the render loop
+	reads the latest published state from a "front" buffer.
+
+	how it works:-
+
+	three buffers are used, back (owned by the update loop), front (owned by the render loop)
+	and middle (the last published one, owned by none).
+
+	publish() swaps back and middle, fetching the latest state swaps front and middle, only
+	if a new state has been published since the last fetch. each swap is a single atomic
+	exchange of the middle index, so none of the loops ever waits for the other.
+
+	with only two buffers, the update loop can't publish while the render loop is still
+	reading the front buffer, that would need a lock, that's why we need the third buffer.
+
+	how to use:-
+
+	SNAPSHOT<STATE> snapshot;
+
+	// in Update()
+
+	snapshot.write() = current_state;	// or modify the members of snapshot.write()
+
+	snapshot.publish();
+
+	// in Render()
+
+	const STATE &state = snapshot.read();	// latest published state
+
+	!!!! after publish(), write() refers to a buffer that holds an older state, so
+	!!!! write the whole state before each publish()
+
+	!!!! only one thread may call write() - publish() and only one thread may call read()
+*/
+
+template<typename T>
+
+class bb::SNAPSHOT
+{
+	static constexpr uint8_t FRESH = 4;	// set in middle if it holds a state not yet read
+
+	std::array<T, 3> buffer;
+
+	std::atomic<uint8_t> middle;
+
+	uint8_t back, front;
+
+
+	public:
+
+
+	SNAPSHOT() : middle(1), back(0), front(2)
+	{}
+
+
+	// the buffer to write the next state in (update side)
+
+	T& write() noexcept
+	{
+		return buffer[back];
+	}
+
+
+	// publish the state written in write() buffer (update side)
+
+	void publish() noexcept
+	{
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+	}
+
+
+	// latest published state (render side)
+
+	const T& read() noexcept
+	{
+		if(middle.load(std::memory_order_relaxed) & FRESH)
+		{
+			front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+		}
+
+		return buffer[front];
+	}
+};
@@ -0,0 +1,522 @@
+#pragma once
+
+#include<thread>
+
+#include<atomic>
+
+#include<mutex>
+
+#include<condition_variable>
+
+#include<deque>
+
+#include<vector>
+
+#include<memory>
+
+#include<functional>
+
+#include<algorithm>
+
+#include<type_traits>
+
+
+namespace bb
+{
+	class JOB_SYSTEM;
+
+	class JOB_GRAPH;
+}
+
+
+/*
+	This is a small work stealing thread pool, it runs short jobs (functions) on all the cpu cores,
+	so that heavy work of a frame (say, updating thousands of particles) can be split among the cores.
+
+	**********************************
+	Let me describe it's inner working
+	**********************************
+
+	The pool starts one worker thread for each core, except one, as the thread that waits for the
+	jobs to complete helps to run them too. The workers are started only when the first job is
+	submitted, so a game that never uses the pool doesn't pay for it.
+
+	Each worker has its own queue (a deque) of jobs, a worker takes the jobs from the back of its own
+	queue (the newest, most likely still in its cache), when its queue is empty, it "steals" the jobs
+	from the front of the other workers' queues (the oldest). So each worker mostly works on its own
+	queue without disturbing others and no core sits idle while others have jobs waiting.
+
+	each queue is guarded by its own mutex, held only to push or pop a job, so the workers rarely
+	contend with each other.
+
+	when there is no job at all, the workers sleep on a condition variable, they don't spin.
+
+	jobs submitted from a worker go to its own queue, jobs submitted from other threads (say, update
+	thread) are spread over all the queues in round robin order.
+
+	*****************
+	How to use it
+	*****************
+
+	JOB_SYSTEM jobs;	// one worker per core (minus one), or JOB_SYSTEM jobs(4) for 4 workers
+
+	GAME_LOOP owns a JOB_SYSTEM, access it with jobs() from Update() etc.
+
+	Parallel For:
+	-------------
+
+	// call fn(i) for each i in [0, 10000), split into chunks run in parallel
+
+	jobs.parallel_for(0, 10000, [&](size_t i) { particles[i].update(dt); });
+
+	// or call fn(begin, end) for each chunk, it's faster for very small jobs
+
+	jobs.parallel_for(0, 10000, [&](size_t begin, size_t end) { for(...) ... });
+
+	// chunk size can be set by the last argument, by default the range is split in 4 chunks per thread
+
+	jobs.parallel_for(0, 10000, fn, 256);
+
+	parallel_for() returns after all the chunks are done, the calling thread runs chunks too.
+
+	Submit and Wait:
+	----------------
+
+	std::atomic<size_t> counter = 0;
+
+	jobs.submit([] { ... }, counter);	// counter is incremented now, decremented when the job is done
+
+	jobs.submit([] { ... }, counter);
+
+	jobs.wait(counter);	// runs jobs while waiting for the counter to become 0
+
+	Task Graph:
+	-----------
+
+	JOB_GRAPH graph;
+
+	auto physics = graph.add([] { ... });
+
+	auto particles = graph.add([] { ... });
+
+	auto collision = graph.add([] { ... });
+
+	graph.precede(physics, collision);	// collision starts only after physics is done
+
+	jobs.run(graph);	// runs all the jobs, independent ones in parallel, returns when all are done
+
+	a graph can be run again and again (say, once in each update).
+
+	------------------
+	~~~~ Caution: ~~~~
+	------------------
+
+	Jobs must not throw exceptions.
+
+	The pool doesn't protect the data, the jobs running in parallel must not modify the same data.
+*/
+
+class bb::JOB_SYSTEM
+{
+	public:
+
+
+	using job_type = std::function<void()>;
+
+
+	private:
+
+
+	struct QUEUE
+	{
+		std::mutex lock;
+
+		std::deque<job_type> jobs;
+	};
+
+
+	std::vector<std::unique_ptr<QUEUE>> queues;	// one per worker (at least one)
+
+	std::vector<std::thread> workers;
+
+	size_t worker_count;
+
+	std::once_flag start_flag;	// workers are started by the first submit()
+
+	std::atomic_bool running;
+
+	std::atomic<size_t> pending;	// no. of jobs waiting in the queues
+
+	std::atomic<size_t> sleepers;	// no. of workers sleeping
+
+	std::atomic<size_t> next_queue;	// round robin queue for jobs from outside the pool
+
+	std::mutex sleep_lock;
+
+	std::condition_variable wake;
+
+	// index of the queue of the current thread, if it is a worker of this pool
+
+	inline static thread_local const JOB_SYSTEM *current_pool = nullptr;
+
+	inline static thread_local size_t current_index = 0;
+
+
+	void start()
+	{
+		running = true;
+
+		for(size_t i = 0; i < worker_count; i++)
+		{
+			workers.emplace_back(&JOB_SYSTEM::worker_loop, this, i);
+		}
+	}
+
+
+	void worker_loop(size_t index)
+	{
+		current_pool = this;
+
+		current_index = index;
+
+		while(true)
+		{
+			if(run_one())
+			{
+				continue;
+			}
+
+			// nothing to do, sleep till a job is submitted
+
+			sleepers++;
+
+			{
+				std::unique_lock<std::mutex> guard(sleep_lock);
+
+				wake.wait(guard, [this] { return pending > 0 || !running; });
+			}
+
+			sleepers--;
+
+			if(!running && pending == 0)
+			{
+				return;
+			}
+		}
+	}
+
+
+	// pop a job from the back of a queue (own queue) or steal it from the front
+
+	bool take(size_t index, bool steal, job_type &job)
+	{
+		QUEUE &queue = *queues[index];
+
+		std::lock_guard<std::mutex> guard(queue.lock);
+
+		if(queue.jobs.empty())
+		{
+			return false;
+		}
+
+		if(steal)
+		{
+			job = std::move(queue.jobs.front());
+
+			queue.jobs.pop_front();
+		}
+		else
+		{
+			job = std::move(queue.jobs.back());
+
+			queue.jobs.pop_back();
+		}
+
+		pending--;
+
+		return true;
+	}
+
+
+	/*
+		run one job if available, from own queue first then from the others, returns
+		false if all the queues are empty
+	*/
+
+	bool run_one()
+	{
+		job_type job;
+
+		size_t own = (current_pool == this) ? current_index : next_queue.load(std::memory_order_relaxed) % queues.size();
+
+		bool found = (current_pool == this) && take(own, false, job);
+
+		for(size_t i = 1; !found && i <= queues.size(); i++)
+		{
+			found = take((own + i) % queues.size(), true, job);
+		}
+
+		if(found)
+		{
+			job();
+		}
+
+		return found;
+	}
+
+
+	public:
+
+
+	explicit JOB_SYSTEM(size_t workers_in = std::max(std::thread::hardware_concurrency(), 2u) - 1) :
+		worker_count(workers_in), running(false), pending(0), sleepers(0), next_queue(0)
+	{
+		for(size_t i = 0; i < std::max(worker_count, (size_t)1); i++)
+		{
+			queues.push_back(std::make_unique<QUEUE>());
+		}
+	}
+
+
+	JOB_SYSTEM(const JOB_SYSTEM&) = delete;
+
+	JOB_SYSTEM& operator=(const JOB_SYSTEM&) = delete;
+
+
+	// the remaining jobs are run before the workers stop
+
+	~JOB_SYSTEM()
+	{
+		{
+			std::lock_guard<std::mutex> guard(sleep_lock);
+
+			running = false;
+		}
+
+		wake.notify_all();
+
+		for(auto &worker : workers)
+		{
+			worker.join();
+		}
+
+		while(run_one());	// in case there is no worker
+	}
+
+
+	// no. of threads that run the jobs (workers + the waiting thread)
+
+	size_t thread_count() const noexcept
+	{
+		return worker_count + 1;
+	}
+
+
+	// submit a job to be run by any thread of the pool
+
+	void submit(job_type job)
+	{
+		std::call_once(start_flag, &JOB_SYSTEM::start, this);
+
+		size_t index = (current_pool == this) ? current_index : next_queue++ % queues.size();
+
+		pending++;	// incremented before the push, so that take() never makes it negative
+
+		{
+			std::lock_guard<std::mutex> guard(queues[index]->lock);
+
+			queues[index]->jobs.push_back(std::move(job));
+		}
+
+		if(sleepers > 0)
+		{
+			// lock to make sure a worker about to sleep doesn't miss the notification
+
+			{ std::lock_guard<std::mutex> guard(sleep_lock); }
+
+			wake.notify_one();
+		}
+	}
+
+
+	// submit a job and increment the counter, it's decremented when the job is done
+
+	void submit(job_type job, std::atomic<size_t> &counter)
+	{
+		counter++;
+
+		submit([job = std::move(job), &counter]
+		{
+			job();
+
+			counter--;
+		});
+	}
+
+
+	// run the jobs while waiting for the counter to become 0
+
+	void wait(const std::atomic<size_t> &counter)
+	{
+		while(counter > 0)
+		{
+			if(!run_one())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+
+	/*
+		call fn(i) for each i in [begin, end) or fn(chunk_begin, chunk_end) for each chunk,
+		in parallel, returns after all of them are done
+	*/
+
+	template<typename FUNC>
+
+	void parallel_for(size_t begin, size_t end, FUNC &&fn, size_t chunk = 0)
+	{
+		if(begin >= end)
+		{
+			return;
+		}
+
+		size_t count = end - begin;
+
+		if(chunk == 0)
+		{
+			chunk = std::max(count / (thread_count() * 4), (size_t)1);
+		}
+
+		auto run_chunk = [&fn](size_t first, size_t last)
+		{
+			if constexpr (std::is_invocable_v<FUNC, size_t, size_t>)
+			{
+				fn(first, last);
+			}
+			else
+			{
+				for(size_t i = first; i < last; i++)
+				{
+					fn(i);
+				}
+			}
+		};
+
+		std::atomic<size_t> counter = 0;
+
+		// the first chunk is run by this thread, after submitting the rest
+
+		for(size_t first = begin + chunk; first < end; first += chunk)
+		{
+			submit([&run_chunk, first, last = std::min(first + chunk, end)] { run_chunk(first, last); }, counter);
+		}
+
+		run_chunk(begin, std::min(begin + chunk, end));
+
+		wait(counter);
+	}
+
+
+	// run all the jobs of a graph, each after the jobs that precede it, returns after all are done
+
+	void run(JOB_GRAPH &graph);
+};
+
+
+/*
+	a set of jobs and the order between them, see JOB_SYSTEM for usage
+*/
+
+class bb::JOB_GRAPH
+{
+	friend class JOB_SYSTEM;
+
+	struct NODE
+	{
+		std::function<void()> job;
+
+		std::vector<size_t> next;	// jobs waiting for this one
+
+		size_t dependencies = 0;	// no. of jobs this one waits for
+
+		std::atomic<size_t> remaining = 0;	// dependencies not done yet in the current run
+	};
+
+	std::deque<NODE> nodes;	// deque, as NODE can't be moved (atomic)
+
+
+	public:
+
+
+	// add a job, returns its id
+
+	size_t add(std::function<void()> job)
+	{
+		nodes.emplace_back().job = std::move(job);
+
+		return nodes.size() - 1;
+	}
+
+
+	// job "after" starts only after job "before" is done
+
+	void precede(size_t before, size_t after)
+	{
+		nodes[before].next.push_back(after);
+
+		nodes[after].dependencies++;
+	}
+
+
+	size_t size() const noexcept
+	{
+		return nodes.size();
+	}
+
+
+	void clear() noexcept
+	{
+		nodes.clear();
+	}
+};
+
+
+inline void bb::JOB_SYSTEM::run(JOB_GRAPH &graph)
+{
+	std::atomic<size_t> counter = 0;
+
+	for(auto &node : graph.nodes)
+	{
+		node.remaining = node.dependencies;
+	}
+
+	// a job submits the jobs waiting for it, once it is the last of their dependencies
+
+	std::function<void(size_t)> launch = [&](size_t id)
+	{
+		submit([&, id]
+		{
+			graph.nodes[id].job();
+
+			for(size_t next : graph.nodes[id].next)
+			{
+				if(--graph.nodes[next].remaining == 0)
+				{
+					launch(next);
+				}
+			}
+		}, counter);
+	};
+
+	for(size_t id = 0; id < graph.nodes.size(); id++)
+	{
+		if(graph.nodes[id].dependencies == 0)
+		{
+			launch(id);
+		}
+	}
+
+	wait(counter);
+}
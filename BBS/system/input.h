@@ -5,14 +5,22 @@
 
 	here we detect only key and mouse button press and current position
 	of mouse pointer on the window
+
+	in PIPELINE mode of the game loop (see game_loop.h) the events are polled
+	on the main thread by poll() and handed over to the update thread, where
+	sync() processes them, instead of doing both in scan()
 */
 
 
 #pragma once
 
 
+#include<vector>
+
 #include"window.h"
 
+#include"../utility/spsc_queue.h"
+
 
 namespace bb
 {
@@ -36,77 +44,134 @@ class bb::InputClass
 
 	bool m_close;	// to detect the window close event
 
-public:
+	SPSC_QUEUE<std::vector<sf::Event>, 4> m_batches;	// events polled by poll(), waiting for sync()
 
-	InputClass()
-	{
-		// by default repeated key inputs are disabled
+	// initializing the member variables to cleanup their previous values
 
-		WINDOW.setKeyRepeatEnabled(false);
-	}
-
-	// look for events, this function must be called in each iteration of game loop
-
-	void scan()
+	void reset()
 	{
-		// initializing the member variables to cleanup their previous values
-
 		m_close = false;
 
 		m_key = sf::Keyboard::Scan::ScancodeCount;
 
 		m_button = sf::Mouse::ButtonCount;
+	}
 
-		while (WINDOW.pollEvent(m_event))
+	void process(const sf::Event &event)
+	{
+		switch (event.type)
 		{
-			switch (m_event.type)
-			{
-			case sf::Event::Closed:
+		case sf::Event::Closed:
+
+			m_close = true;
 
-				m_close = true;
+			break;
 
-				break;
+		case sf::Event::KeyPressed:
 
-			case sf::Event::KeyPressed:
+			// getting only one key, forget the rest
 
-				// getting only one key, forget the rest
+			m_key = event.key.scancode;
 
-				m_key = m_event.key.scancode;
+			m_keyState = true;
 
-				m_keyState = true;
+			break;
 
-				break;
+		case sf::Event::KeyReleased:
 
-			case sf::Event::KeyReleased:
+			// getting only one key, forget the rest
 
-				// getting only one key, forget the rest
+			m_key = event.key.scancode;
 
-				m_key = m_event.key.scancode;
+			m_keyState = false;
 
-				m_keyState = false;
+			break;
 
-				break;
+		case sf::Event::MouseButtonPressed:
 
-			case sf::Event::MouseButtonPressed:
+			// getting only one button, forget the rest
 
-				// getting only one button, forget the rest
+			m_button = event.mouseButton.button;
 
-				m_button = m_event.mouseButton.button;
+			m_buttonState = true;
 
-				m_buttonState = true;
+			break;
 
-				break;
+		case sf::Event::MouseButtonReleased:
 
-			case sf::Event::MouseButtonReleased:
+			// getting only one button, forget the rest
 
-				// getting only one button, forget the rest
+			m_button = event.mouseButton.button;
 
-				m_button = m_event.mouseButton.button;
+			m_buttonState = false;
 
-				m_buttonState = false;
+			break;
+		}
+	}
+
+public:
+
+	InputClass()
+	{
+		// by default repeated key inputs are disabled
+
+		WINDOW.setKeyRepeatEnabled(false);
+	}
 
-				break;
+	// look for events, this function must be called in each iteration of game loop
+
+	void scan()
+	{
+		reset();
+
+		while (WINDOW.pollEvent(m_event))
+		{
+			process(m_event);
+		}
+	}
+
+	/*
+		PIPELINE mode, poll the events of the window (call it from the thread that created
+		the window) and keep them for sync(), if too many polls are waiting for sync(), the
+		events are left in the window to be polled next time
+	*/
+
+	void poll()
+	{
+		auto batch = m_batches.back();
+
+		if (!batch)
+		{
+			return;
+		}
+
+		batch->clear();
+
+		while (WINDOW.pollEvent(m_event))
+		{
+			batch->push_back(m_event);
+		}
+
+		m_batches.push();
+	}
+
+	/*
+		PIPELINE mode, process the events kept by poll() (call it from the update thread),
+		like scan() it forgets the previous events, so call it before each update
+	*/
+
+	void sync()
+	{
+		reset();
+
+		while (auto batch = m_batches.front())
+		{
+			for (const sf::Event &event : *batch)
+			{
+				process(event);
 			}
+
+			m_batches.pop();
 		}
 	}
 
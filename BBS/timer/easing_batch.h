@@ -0,0 +1,676 @@
+#pragma once
+
+#include<vector>
+
+#include<cmath>
+
+#include<numbers>
+
+#include<algorithm>
+
+#include<cstddef>
+
+#include"tween_accessories.h"	// TWN_TYPE
+
+
+namespace bb
+{
+	struct TWN_MATH;
+
+	template<double (*EASE)(double)>
+
+	struct TWN_KERNEL;
+
+	struct TWN_BATCH;
+
+	class TWN_LUT;
+}
+
+
+
+/*
+	the easing functions of TWN_TYPE (see tween_accessories.h) call std::pow(), std::sin(), std::cos()
+	for each value, these are library calls, a loop calling them can't be vectorized, this file has
+	two faster ways to ease many values at once.
+
+	batched easing:-
+
+	TWN_BATCH::ease<TWN_TYPE::out_cubic>(progress, eased, count);	// eased[i] = out_cubic(progress[i])
+
+	each easing function of TWN_TYPE has a TWN_KERNEL<> that computes the same curve without library
+	calls (except std::sqrt() for circ) or if-else, only multiplications, additions and selections, so
+	the compiler vectorizes the loop of ease<>() (SSE, AVX, NEON, whatever the build targets, use -O3
+	with gcc, it doesn't vectorize such loops at -O2, add -march=native or /arch:AVX2 for wider vectors
+	and -fno-math-errno for sqrt), the results differ from TWN_TYPE by less than 2e-15 (about 1.5e-15
+	at most, measured by benchmark/easing_benchmark.cpp).
+
+	any other double(double) function works too, it's just called in the loop.
+
+	lookup table:-
+
+	TWN_LUT lut(TWN_TYPE::in_out_elastic, 1024);	// samples the curve at 1025 evenly spaced points
+
+	lut(0.3);	// linear interpolation between the nearest samples
+
+	lut.ease(progress, eased, count);
+
+	lut.max_error();	// estimate of the error, the largest one measured between each pair of samples, plus 1/16 of it
+
+	the estimate is not a guaranteed bound, the error is measured at 17 points between each pair of
+	samples, a curve that bends sharply between those points (like the kinks of bounce) can be off by
+	a little more, for the easing curves of TWN_TYPE the benchmark finds the error within the estimate.
+
+	TWN_LUT lut = TWN_LUT::with_max_error(TWN_TYPE::in_out_elastic, 1e-4);	// as few samples as needed for this error
+
+	the cost of a lookup is the same for all the curves, so it's useful for the costly ones or the
+	custom curves (TWN_TYPE::func).
+
+	TWEEN_MANAGER (see tween_manager.h) eases each group of tweens with TWN_BATCH.
+
+	benchmark/easing_benchmark.cpp compares the accuracy and the speed of these with TWN_TYPE.
+*/
+
+// helpers of the kernels, can be vectorized, valid for the ranges used by the kernels
+
+struct bb::TWN_MATH
+{
+	// sin(a), |a| < 1000
+
+	static double sin(double a) noexcept
+	{
+		constexpr double PI_HI = 3.141592653589793;
+
+		constexpr double PI_LO = 1.2246467991473532e-16;
+
+		// a = k * pi + r, r in [-pi/2, pi/2], sin(a) = (-1)^k * sin(r)
+
+		// rounded with int conversions, not std::floor(), which isn't vectorized unless -fno-trapping-math
+
+		double v = a * std::numbers::inv_pi;
+
+		double k = (double)(int)(v + ((v >= 0.0) ? 0.5 : -0.5));
+
+		double r = (a - k * PI_HI) - k * PI_LO;
+
+		double odd = k - 2.0 * (double)(int)(k * 0.5);	// -1, 0 or 1
+
+		double sign = 1.0 - 2.0 * odd * odd;
+
+		// taylor series till r^21, error < 1e-18
+
+		double r2 = r * r;
+
+		double p = 1.0 / 51090942171709440000.0;
+
+		p = p * r2 - 1.0 / 121645100408832000.0;
+
+		p = p * r2 + 1.0 / 355687428096000.0;
+
+		p = p * r2 - 1.0 / 1307674368000.0;
+
+		p = p * r2 + 1.0 / 6227020800.0;
+
+		p = p * r2 - 1.0 / 39916800.0;
+
+		p = p * r2 + 1.0 / 362880.0;
+
+		p = p * r2 - 1.0 / 5040.0;
+
+		p = p * r2 + 1.0 / 120.0;
+
+		p = p * r2 - 1.0 / 6.0;
+
+		p = p * r2 + 1.0;
+
+		return sign * r * p;
+	}
+
+
+	static double cos(double a) noexcept
+	{
+		return sin(a + std::numbers::pi / 2.0);
+	}
+
+
+	// 2^t, |t| <= 16
+
+	static double exp2(double t) noexcept
+	{
+		// 2^t = (2^(t / 16))^16, |t / 16 * ln 2| <= 0.7, taylor series till x^12
+
+		double x = t * (std::numbers::ln2 / 16.0);
+
+		double p = 1.0 / 479001600.0;
+
+		p = p * x + 1.0 / 39916800.0;
+
+		p = p * x + 1.0 / 3628800.0;
+
+		p = p * x + 1.0 / 362880.0;
+
+		p = p * x + 1.0 / 40320.0;
+
+		p = p * x + 1.0 / 5040.0;
+
+		p = p * x + 1.0 / 720.0;
+
+		p = p * x + 1.0 / 120.0;
+
+		p = p * x + 1.0 / 24.0;
+
+		p = p * x + 1.0 / 6.0;
+
+		p = p * x + 0.5;
+
+		p = p * x + 1.0;
+
+		p = p * x + 1.0;
+
+		p *= p;
+
+		p *= p;
+
+		p *= p;
+
+		return p * p;
+	}
+};
+
+
+/*
+	TWN_KERNEL<EASE>::eval(x) is EASE(x), for x in [0, 1], written to be vectorized
+*/
+
+template<double (*EASE)(double)>
+
+struct bb::TWN_KERNEL
+{
+	// a function without a kernel
+
+	static double eval(double x) noexcept
+	{
+		return EASE(x);
+	}
+};
+
+
+namespace bb
+{
+	// sine
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_sine>
+	{
+		static double eval(double x) noexcept
+		{
+			return 1.0 - TWN_MATH::cos((x * std::numbers::pi) / 2.0);
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_sine>
+	{
+		static double eval(double x) noexcept
+		{
+			return TWN_MATH::sin((x * std::numbers::pi) / 2.0);
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_sine>
+	{
+		static double eval(double x) noexcept
+		{
+			return -(TWN_MATH::cos(std::numbers::pi * x) - 1.0) / 2.0;
+		}
+	};
+
+
+	// quad
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_quad>
+	{
+		static double eval(double x) noexcept
+		{
+			double p = -2.0 * x + 2.0;
+
+			return (x < 0.5) ? 2.0 * x * x : 1.0 - p * p / 2.0;
+		}
+	};
+
+
+	// cubic
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_cubic>
+	{
+		static double eval(double x) noexcept
+		{
+			double p = 1.0 - x;
+
+			return 1.0 - p * p * p;
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_cubic>
+	{
+		static double eval(double x) noexcept
+		{
+			double p = -2.0 * x + 2.0;
+
+			return (x < 0.5) ? 4.0 * x * x * x : 1.0 - p * p * p / 2.0;
+		}
+	};
+
+
+	// quart
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_quart>
+	{
+		static double eval(double x) noexcept
+		{
+			double p = (1.0 - x) * (1.0 - x);
+
+			return 1.0 - p * p;
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_quart>
+	{
+		static double eval(double x) noexcept
+		{
+			double p = (-2.0 * x + 2.0) * (-2.0 * x + 2.0);
+
+			return (x < 0.5) ? 8.0 * x * x * x * x : 1.0 - p * p / 2.0;
+		}
+	};
+
+
+	// quint
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_quint>
+	{
+		static double eval(double x) noexcept
+		{
+			double p = 1.0 - x;
+
+			return 1.0 - p * p * p * p * p;
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_quint>
+	{
+		static double eval(double x) noexcept
+		{
+			double p = -2.0 * x + 2.0;
+
+			return (x < 0.5) ? 16.0 * x * x * x * x * x : 1.0 - p * p * p * p * p / 2.0;
+		}
+	};
+
+
+	// expo
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_expo>
+	{
+		static double eval(double x) noexcept
+		{
+			return (x == 0.0) ? 0.0 : TWN_MATH::exp2(10.0 * x - 10.0);
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_expo>
+	{
+		static double eval(double x) noexcept
+		{
+			return (x == 1.0) ? 1.0 : 1.0 - TWN_MATH::exp2(-10.0 * x);
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_expo>
+	{
+		static double eval(double x) noexcept
+		{
+			double in = TWN_MATH::exp2(20.0 * x - 10.0) / 2.0;
+
+			double out = (2.0 - TWN_MATH::exp2(-20.0 * x + 10.0)) / 2.0;
+
+			return (x == 0.0) ? 0.0 : (x == 1.0) ? 1.0 : (x < 0.5) ? in : out;
+		}
+	};
+
+
+	// circ
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_circ>
+	{
+		static double eval(double x) noexcept
+		{
+			return 1.0 - std::sqrt(1.0 - x * x);
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_circ>
+	{
+		static double eval(double x) noexcept
+		{
+			return std::sqrt(1.0 - (x - 1.0) * (x - 1.0));
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_circ>
+	{
+		static double eval(double x) noexcept
+		{
+			// the argument of sqrt is the same for both the halves, only its sign in the result changes
+
+			double p = (x < 0.5) ? 2.0 * x : -2.0 * x + 2.0;
+
+			double root = std::sqrt(1.0 - p * p);
+
+			return (x < 0.5) ? (1.0 - root) / 2.0 : (root + 1.0) / 2.0;
+		}
+	};
+
+
+	// back
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_back>
+	{
+		static double eval(double x) noexcept
+		{
+			constexpr double c1 = 1.70158;
+			constexpr double c3 = c1 + 1.0;
+
+			double p = x - 1.0;
+
+			return 1.0 + c3 * p * p * p + c1 * p * p;
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_back>
+	{
+		static double eval(double x) noexcept
+		{
+			constexpr double c1 = 1.70158;
+			constexpr double c2 = c1 * 1.525;
+
+			double p = 2.0 * x;
+
+			double q = 2.0 * x - 2.0;
+
+			return (x < 0.5)
+				? (p * p * ((c2 + 1.0) * 2.0 * x - c2)) / 2.0
+				: (q * q * ((c2 + 1.0) * q + c2) + 2.0) / 2.0;
+		}
+	};
+
+
+	// elastic
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_elastic>
+	{
+		static double eval(double x) noexcept
+		{
+			constexpr double c4 = (2.0 * std::numbers::pi) / 3.0;
+
+			double y = -TWN_MATH::exp2(10.0 * x - 10.0) * TWN_MATH::sin((x * 10.0 - 10.75) * c4);
+
+			// 0 at x = 0 as a product, gcc doesn't vectorize the loop with a selection here
+
+			y *= (double)(x != 0.0);
+
+			return (x == 1.0) ? 1.0 : y;
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_elastic>
+	{
+		static double eval(double x) noexcept
+		{
+			constexpr double c4 = (2.0 * std::numbers::pi) / 3.0;
+
+			double y = TWN_MATH::exp2(-10.0 * x) * TWN_MATH::sin((x * 10.0 - 0.75) * c4) + 1.0;
+
+			y *= (double)(x != 0.0);
+
+			return (x == 1.0) ? 1.0 : y;
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_elastic>
+	{
+		static double eval(double x) noexcept
+		{
+			constexpr double c5 = (2.0 * std::numbers::pi) / 4.5;
+
+			// one exp2() for both the halves, 2^(20x - 10) or 2^(-20x + 10)
+
+			double t = (x < 0.5) ? 20.0 * x - 10.0 : -20.0 * x + 10.0;
+
+			double y = TWN_MATH::exp2(t) * TWN_MATH::sin((20.0 * x - 11.125) * c5) / 2.0;
+
+			y = (x < 0.5) ? -y : y + 1.0;
+
+			y *= (double)(x != 0.0);
+
+			return (x == 1.0) ? 1.0 : y;
+		}
+	};
+
+
+	// bounce
+
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::out_bounce>
+	{
+		static double eval(double x) noexcept
+		{
+			constexpr double n1 = 7.5625;
+			constexpr double d1 = 2.75;
+
+			// the four parabolas differ only in the shift and the offset
+
+			double shift = (x < 1.0 / d1) ? 0.0 : (x < 2.0 / d1) ? 1.5 / d1 : (x < 2.5 / d1) ? 2.25 / d1 : 2.625 / d1;
+
+			double offset = (x < 1.0 / d1) ? 0.0 : (x < 2.0 / d1) ? 0.75 : (x < 2.5 / d1) ? 0.9375 : 0.984375;
+
+			x -= shift;
+
+			return n1 * x * x + offset;
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_bounce>
+	{
+		static double eval(double x) noexcept
+		{
+			return 1.0 - TWN_KERNEL<TWN_TYPE::out_bounce>::eval(1.0 - x);
+		}
+	};
+
+	template<>
+
+	struct TWN_KERNEL<TWN_TYPE::in_out_bounce>
+	{
+		static double eval(double x) noexcept
+		{
+			double y = TWN_KERNEL<TWN_TYPE::out_bounce>::eval((x < 0.5) ? 1.0 - 2.0 * x : 2.0 * x - 1.0);
+
+			return (x < 0.5) ? (1.0 - y) / 2.0 : (1.0 + y) / 2.0;
+		}
+	};
+}
+
+
+
+struct bb::TWN_BATCH
+{
+	// out[i] = EASE(in[i]), in[i] in [0, 1], in and out can be the same array
+
+	template<double (*EASE)(double)>
+
+	static void ease(const double *in, double *out, size_t count) noexcept
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			out[i] = TWN_KERNEL<EASE>::eval(in[i]);
+		}
+	}
+};
+
+
+
+class bb::TWN_LUT
+{
+	std::vector<double> table;	// samples + 1 values of the curve, at 0, 1 / samples, 2 / samples ... 1
+
+	double scale;	// no. of samples
+
+	double at_0, at_1;	// the values at 0 and 1, the curves like in_expo jump there
+
+	double error;	// estimate of the error
+
+
+	public:
+
+
+	// samples the curve at samples + 1 evenly spaced points in [0, 1]
+
+	TWN_LUT(const TWN_TYPE::func &ease, size_t samples = 1024) : table(std::max(samples, (size_t)1) + 1), scale((double)(table.size() - 1)), at_0(ease(0.0)), at_1(ease(1.0)), error(0)
+	{
+		// the first and the last samples are taken right next to 0 and 1, to interpolate without the jumps
+
+		for(size_t i = 0; i < table.size(); i++)
+		{
+			table[i] = ease(std::clamp(i / scale, 1e-12, 1.0 - 1e-12));
+		}
+
+		/*
+			measuring the error between the samples, at 15 evenly spaced points and right next to
+			the samples (to catch a jump, like in_expo at 0), plus 1/16 of it for the points missed
+		*/
+
+		for(size_t i = 0; i + 1 < table.size(); i++)
+		{
+			for(int j = 0; j <= 16; j++)
+			{
+				double x = (i + std::clamp(j / 16.0, 1e-9, 1.0 - 1e-9)) / scale;
+
+				error = std::max(error, std::abs((*this)(x) - ease(x)));
+			}
+		}
+
+		error *= 1.0 + 1.0 / 16.0;
+	}
+
+
+	// the fewest samples (a power of 2, up to max_samples) for an estimated error <= max_error
+
+	static TWN_LUT with_max_error(const TWN_TYPE::func &ease, double max_error, size_t max_samples = 1 << 16)
+	{
+		size_t samples = 16;
+
+		TWN_LUT lut(ease, samples);
+
+		while(lut.error > max_error && samples < max_samples)
+		{
+			samples *= 2;
+
+			lut = TWN_LUT(ease, samples);
+		}
+
+		return lut;
+	}
+
+
+	double operator()(double x) const noexcept
+	{
+		if(x <= 0.0 || x >= 1.0)
+		{
+			return (x <= 0.0) ? at_0 : at_1;
+		}
+
+		double position = x * scale;
+
+		size_t i = std::min((size_t)position, table.size() - 2);
+
+		return table[i] + (table[i + 1] - table[i]) * (position - i);
+	}
+
+
+	// out[i] = lut(in[i]), in and out can be the same array
+
+	void ease(const double *in, double *out, size_t count) const noexcept
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			out[i] = (*this)(in[i]);
+		}
+	}
+
+
+	// estimate of the largest difference from the curve, see the constructor
+
+	double max_error() const noexcept
+	{
+		return error;
+	}
+
+
+	size_t samples() const noexcept
+	{
+		return table.size() - 1;
+	}
+};
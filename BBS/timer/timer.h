@@ -15,6 +15,10 @@
 
 #include"tween_accessories.h"
 
+#include"timer_scheduler.h"	// runs the update loops of the asynchronous timers
+
+#include"../utility/clock.h"	// the clock of the whole game engine
+
 
 
 
@@ -97,6 +101,8 @@ namespace bb
 
 	   - Use twn() and twn_list() from tween_accessories.h to construct the tween tuple(s).
 	   - The 'ease' parameter is optional; if omitted, the default easing function is used.
+	   - To inline the easing function in the update loop, pass it as a template argument,
+		 twn<TWN_TYPE::in_quad>(ref, start, end), see TWN_EASE in tween_accessories.h.
 
 	3. To safely access tweened variables (e.g., in a render loop), use:
 		 tween.lock();
@@ -106,7 +112,7 @@ namespace bb
 	4. To execute the final callback (if provided) after tweening completes, call:
 		 tween.xfinal();
 
-	5. To check if the tween thread is running:
+	5. To check if the tween is running:
 		 if (tween.is_running()) { ... }
 
 	6. To stop the tween immediately and reset the state, don't call it in lock() - unlock() section:
@@ -114,19 +120,22 @@ namespace bb
 
 	Notes:
 	------
-	- The update loop runs in a separate thread; always use lock()/unlock() when accessing shared data.
+	- The update loop runs on TIMER_SCHEDULER (a single thread shared by all the timers, see timer_scheduler.h),
+	  not on the thread calling start(); always use lock()/unlock() when accessing shared data.
 	- The final callback receives the total elapsed time as its argument.
 	- start() fails to execute if the tween is already running.
 	- The class supports pausing and resuming via pause_time() and resume_time(), see, Pause - Resume Time
 	  section of BASE_ASYNCHRONOUS_TIMER class for more details.
+	- To animate hundreds or thousands of variables at once, use TWEEN_MANAGER (see tween_manager.h), it
+	  updates all of them in one pass from Update(), much cheaper than a TWEENER for each.
 
 	-~~~~~~~~~~~~~~-
 	 INTERVAL_TIMER
 	-~~~~~~~~~~~~~~-
 
 	INTERVAL_TIMER is an asynchronous timer class that repeatedly calls a user-provided callback function at
-	fixed intervals, from an update loop in a separate thread. The timer continues to invoke the callback
-	every interval until the callback returns false, at which point the update thread stops
+	fixed intervals, from an update loop run by TIMER_SCHEDULER. The timer continues to invoke the callback
+	every interval until the callback returns false, at which point the update loop stops
 
 	Usage:
 	------
@@ -153,7 +162,7 @@ namespace bb
 
 	Notes:
 	------
-	- The update loop runs in a separate thread; always use lock()/unlock() when accessing shared data.
+	- The update loop runs on TIMER_SCHEDULER, as in TWEENER; always use lock()/unlock() when accessing shared data.
 	- The callback receives the elapsed time for each interval as its argument and returns a boolean
 	  indicating whether to continue the timer (true) or stop it (false).
 	- The final callback receives the total elapsed time as its argument.
@@ -168,6 +177,9 @@ namespace bb
 
 	the internal time_point is initialized by the constructor and can be
 	reset by reset().
+
+	time is read from the engine clock (see clock.h), so all the timers
+	follow its mode (real, scaled or manual)
 */
 
 class bb::TIMER
@@ -193,7 +205,7 @@ class bb::TIMER
 
 	// constructor initializes clk_previous with current timepoint
 	
-	TIMER() : clk_previous{ std::chrono::steady_clock::now() }, offset{ 0 }
+	TIMER() : clk_previous{ CLOCK.now() }, offset{ 0 }
 	{}
 
 
@@ -201,7 +213,7 @@ class bb::TIMER
 
 	void reset() noexcept
 	{
-		clk_previous = std::chrono::steady_clock::now();
+		clk_previous = CLOCK.now();
 
 		offset = 0;
 	}
@@ -221,7 +233,7 @@ class bb::TIMER
 
 	double elapsed_time() const noexcept
 	{
-		return std::chrono::duration_cast<duration>(std::chrono::steady_clock::now() - clk_previous).count() - offset;
+		return std::chrono::duration_cast<duration>(CLOCK.now() - clk_previous).count() - offset;
 	}
 };
 
@@ -241,19 +253,19 @@ class bb::TIMER
 
 	<*> brief description of final calling system:
 
-	This asynchronous timer, when started, runs its update loop on a separate thread.
-	Once this update loop finishes, the thread must call set_final() to prepare to execute
-	its final() callback.
+	This asynchronous timer, when started, runs its update loop on the timer scheduler
+	(see timer_scheduler.h). Once this update loop finishes, the scheduler calls set_final()
+	to prepare to execute its final() callback.
 
 	A key challenge here is that final() itself must be executed by a different thread,
-	not the same update thread that set it. To ensure this happens without race conditions,
-	set_final() locks final_lock, which prevents any other update thread from setting up
-	another final() before the current one is handled.
+	not the scheduler that set it. To ensure this happens without race conditions,
+	set_final() locks final_lock, which prevents the next run of the update loop from setting
+	up another final() before the current one is handled.
 
 	After set_final() has secured this lock, the xfinal() method, which is called from a
 	separate thread (typically an update or render thread of a game engine), runs the
 	final() callback. Once final() has executed, xfinal() unlocks the final_lock, making
-	it possible for future update threads to safely set up and execute their own final() callbacks.
+	it possible for future update loops to safely set up and execute their own final() callbacks.
 
 
 	Start and update loop:
@@ -263,7 +275,9 @@ class bb::TIMER
 	the timer and begins its operation. Returns true if the timer was started successfully,
 	or false if it was already active.
 
-	start() starts a seperate thread that calls a function containing an update loop
+	start() doesn't create a thread, it sets the step function, one iteration of the update
+	loop, and TIMER_SCHEDULER runs it once after each unlock() (see timer_scheduler.h), all the
+	timers share the same thread.
 
 	####################
 	*** note for dev ***
@@ -275,43 +289,30 @@ class bb::TIMER
 	{
 		if (!thread_running)
 		{
-			thread_running = true;	// indicate that the update loop has started
-
-			std::thread(---the update loop---).detach();	// calling detach() as we don't need to access this thread in future
-
-			return true;
-		}
-
-		return false;
-	}
-
-	the general structure of the method with update loop
-
-	update(---the args---)
-	{
-		---
+			timer.reset();
 
-		do
-		{
-			flag.wait(true);
+			set_step([=, this](double &final_time) mutable -> bool
+			{
+				---
+				// one iteration of the update loop, the captured variables
+				// keep their values from one iteration to the next
+				---
 
-			---
-			// don't put any "break" here as the loop must
-			// terminate at the while test below
-			---
+				final_time = ---;	// the argument of final()
 
-			flag = true;
+				return ---;	// true => run the next iteration, false => the update loop is over
+			}, _final);
 
-			flag.notify_all();
-
-		}while(---);
+			thread_running = true;	// indicate that the update loop has started
 
-		---
+			return true;
+		}
 
-		set_final(---);	// must call this before the thread ends
+		return false;
 	}
 
-	flag is a part of "Asynchronous Locking Mechanism" discussed below
+	run_step() runs one iteration and handles the rest, see "Asynchronous Locking Mechanism" and
+	"Stoping the update loop" below.
 
 
 	Asynchronous Locking Mechanism:
@@ -347,96 +348,31 @@ class bb::TIMER
 	*** note for dev ***
 	####################
 
-	an atomic variable "flag" is used, initially it's false
+	an atomic variable "flag" is used, initially it's true
 
-	each iteration of update loop waits if it's true before starting, and sets it to true at the end
+	unlock() sets it to false and posts the timer to TIMER_SCHEDULER, the scheduler runs one iteration
+	(run_step()) and sets it back to true at the end
 
-	each lock() waits if it's false, and unlock() sets it to false
+	each lock() waits if it's false
 
-	so update loop waits untill unlock() sets flag to false, after that lock() waits untill update loop
+	so an iteration runs only after unlock() sets flag to false, after that lock() waits untill the iteration
 	sets it back to true, thus we make sure that the update loop and lock() unlock() sections never get
 	executed simultaneously
 
-	update(---the args---)
-	{
-		---
-
-		do
-		{
-			flag.wait(true);
-
-			---
-			// don't put any "break" here as the loop must
-			// terminate at the while test below
-			---
-
-			flag = true;
-
-			flag.notify_all();
-
-		}while(---);
-
-		---
-
-		set_final(---);	// must call this before the thread ends
-	}
-
-	the structure of the update loop can be anything but the function must
-	call set_final() before the thread ends
-
 	
-	Stoping this internal thread:
-	-----------------------------
-	I added a system to stop the update thread abruptly, just call stop() from anywhere
-	except lock() - unlock() section to stop the update thread immediately without setting
+	Stoping the update loop:
+	------------------------
+	I added a system to stop the update loop abruptly, just call stop() from anywhere
+	except lock() - unlock() section to stop the update loop immediately without setting
 	the final() callabck function.
 
 	####################
 	*** note for dev ***
 	####################
 	
-	it internally uses a lock() - unlock() section to set stop_thread flag which is checked
-	by update loop after stop() calls unlock() and stops the thread, here's how the update
-	function with this stopping mechanism looks like
-
-	update(---the args---)
-	{
-		---
-
-		do
-		{
-			flag.wait(true);
-
-			// #### stopping mechanism after flag wait ####
-
-			if (stop_thread)
-			{
-				// break out of this thread
-
-				thread_running = false;	// stop the update loop
-
-				thread_running.notify_all();	// to notify stop() that the thread has stopped
-
-				return;
-			}
-
-			---
-			// don't put any "break" here as the loop must
-			// terminate at the while test below
-			---
-
-			flag = true;
-
-			flag.notify_all();
-
-		}while(---);
-
-		---
-
-		set_final(---);	// must call this before the thread ends
-	}
-
-	after the thread is stopped, stop() resets all the flags and variables to their initial value
+	stop() cancels the iteration posted to the scheduler (if it's not started yet) or waits for
+	it to end, so after that no iteration is running or waiting, then it resets all the flags and
+	variables to their initial value
 
 	Pause - Resume Time:
 	--------------------
@@ -449,7 +385,7 @@ class bb::TIMER
 	the timer. This way, the timer continues from where it left off when the loop resumes.
 */
 
-class bb::BASE_ASYNCHRONOUS_TIMER
+class bb::BASE_ASYNCHRONOUS_TIMER : public bb::SCHEDULED_TIMER
 {
 	protected:
 
@@ -458,14 +394,16 @@ class bb::BASE_ASYNCHRONOUS_TIMER
 
 	using final_func = std::function<void(double)>;
 
+	// one iteration of the update loop, sets its argument to the argument of final(), returns false when the loop is over
+
+	using step_func = std::function<bool(double&)>;
+
 	// indicates if the timer is rinning or not
 
 	std::atomic_bool thread_running;
 
 	std::atomic_bool flag;	// used for synchronization
 
-	std::atomic_bool stop_thread;	// to stop the update loop abruptly
-
 	TIMER timer;	// internal timer
 
 
@@ -482,42 +420,114 @@ class bb::BASE_ASYNCHRONOUS_TIMER
 
 	double final_dt;	// how long the thread runs before final() is called
 
+	step_func step;	// the update loop, set by start()
 
-	protected:
+	final_func next_final;	// final() of the running update loop, moves to _final by set_final()
 
+	double next_final_dt;	// argument of next_final
 
-	BASE_ASYNCHRONOUS_TIMER() : thread_running(false), flag(true), pause_flag(false), stop_thread(false), _final(nullptr), final_dt(0), final_lock(false)
-	{}
+	bool finishing;	// the update loop is over, waiting to set its final()
 
 
 	/*
-		call it at the end of the thread to take care of thread completion and final locking
+		call it when the update loop is over to take care of its completion and final locking,
+		returns false if the previous final() is not executed yet, then the final() can't be set
 	*/
 
-	void set_final(final_func _final, double elapsed_time) noexcept
+	bool set_final(final_func &_final, double elapsed_time) noexcept
 	{
 		if (_final)
 		{
 			/*
-				after thread_running is false a thread can run quickly and reach this block.
-				in such a case I wait untill the previously set final() is executed
+				if the timer is started again before xfinal() executes the previously set final(),
+				the new final() waits till it's executed
 
 				note: because of this mechanism if you don't execute the final function of a
-				thread with xfinal, any later thread bringing a final() will get stuck here
+				timer with xfinal, any later final() of it will wait forever
 			*/
 
-			final_lock.wait(true);
+			if (final_lock)
+			{
+				return false;
+			}
 
 			final_dt = elapsed_time;
 
-			this->_final = _final;
+			this->_final = std::move(_final);
 
 			final_lock = true;	// signalling xfinal() that final is ready to be executed
 		}
 
-		thread_running = false;	// finally this thread can close
+		thread_running = false;	// finally the update loop is over
+
+		thread_running.notify_all();
+
+		return true;
+	}
+
+
+	protected:
+
+
+	BASE_ASYNCHRONOUS_TIMER() : thread_running(false), flag(true), pause_flag(false), _final(nullptr), final_dt(0), final_lock(false), next_final_dt(0), finishing(false)
+	{}
+
+
+	~BASE_ASYNCHRONOUS_TIMER()
+	{
+		stop();
+	}
+
 
-		thread_running.notify_all();	// to notify stop() (in case of abrupt termination) that the thread has stopped
+	// called by start() to set the update loop and its final()
+
+	void set_step(step_func step, final_func _final) noexcept
+	{
+		this->step = std::move(step);
+
+		next_final = std::move(_final);
+
+		finishing = false;
+	}
+
+
+	/*
+		one iteration of the update loop, run by TIMER_SCHEDULER after each unlock()
+	*/
+
+	void run_step() noexcept override
+	{
+		if (flag || !thread_running)
+		{
+			return;	// no iteration is waiting (posted more than once)
+		}
+
+		if (!finishing)
+		{
+			finishing = !step(next_final_dt);
+		}
+
+		if (finishing)
+		{
+			// the update loop is over, if final() can't be set now, it's tried again after the next unlock()
+
+			flag = true;
+
+			flag.notify_all();
+
+			finishing = false;	// before set_final(), after it the timer can be started again
+
+			if (!set_final(next_final, next_final_dt))
+			{
+				finishing = true;
+			}
+
+			return;
+		}
+
+		flag = true;
+
+		flag.notify_all();
 	}
 
 
@@ -536,7 +546,7 @@ class bb::BASE_ASYNCHRONOUS_TIMER
 	{
 		/*
 			final() is executed only after final_lock is true (final function and it's arg is loaded)
-			and the thread has stopped
+			and the update loop has stopped
 		*/
 
 		if (final_lock && !thread_running)
@@ -587,7 +597,7 @@ class bb::BASE_ASYNCHRONOUS_TIMER
 		{
 			flag = false;
 
-			flag.notify_all();
+			TIMER_SCHEDULER.post(this);
 		}
 	}
 
@@ -632,25 +642,28 @@ class bb::BASE_ASYNCHRONOUS_TIMER
 
 
 	/*
-		stop the update loop, and waits for the thread_running to turn false
-		
-		if the update is running this will stop the thread without setting final() function,
-		but if the update loop has stopped already and set_final() is executing, final()
-		stuffs will be cleared by stop() method, as it resets the flags, so you can call
-		stop() at any time
+		stop the update loop, if the update loop is running this will stop it without setting
+		final() function, but if the update loop has stopped already, the final() set by it
+		will be cleared by stop() method, as it resets the flags, so you can call stop() at
+		any time
 		
 		don't call it from in between lock() and unlock()
 	*/
 
 	void stop() noexcept
 	{
-		lock();
+		// no iteration is running or waiting after this
+
+		if (TIMER_SCHEDULER.cancel(this))
+		{
+			flag = true;
+		}
 
-		stop_thread = true;
+		lock();
 
-		unlock();
+		thread_running = false;
 
-		thread_running.wait(true);	// wait for the thread to stop completely
+		thread_running.notify_all();
 
 		// resetting all the flags and variables to initial form
 
@@ -658,13 +671,19 @@ class bb::BASE_ASYNCHRONOUS_TIMER
 		
 		pause_flag = false;
 
-		stop_thread = false,
+		finishing = false;
+
+		step = nullptr;
+
+		next_final = nullptr;
 			
-		_final = nullptr,
+		_final = nullptr;
 			
 		final_dt = 0;
 		
 		final_lock = false;
+
+		final_lock.notify_all();
 	}
 };
 
@@ -763,54 +782,50 @@ class bb::BASE_ASYNCHRONOUS_TIMER
 
 class bb::TWEENER : public bb::BASE_ASYNCHRONOUS_TIMER
 {
-	// this function is run by the thread created by start()
+	public:
+
+
+	/*
+		documentation of this class explains it's usage
+	*/
 
 	template <typename... TYPE>
 
-	void update(double duration, std::tuple<TYPE...> twn_tuple, final_func _final) noexcept
+	bool start(double duration, std::tuple<TYPE...> twn_list, final_func _final = nullptr) noexcept
 	{
-		double elapsed_time;
-
-		timer.reset();
+		if (!thread_running)
+		{
+			timer.reset();
 
-		do {
-			flag.wait(true);
+			// one iteration of the update loop, run by TIMER_SCHEDULER after each unlock()
 
-			if (stop_thread)
+			set_step([this, duration, twn_tuple = twn_list](double &final_time) mutable noexcept -> bool
 			{
-				// break out of this thread
+				double elapsed_time = timer.elapsed_time();
 
-				thread_running = false;	// stop the update loop
+				if (elapsed_time < duration)
+				{
+					// time is not over yet so we get the time_ratio [0 - 1]
 
-				thread_running.notify_all();	// to notify stop() that the thread has stopped
+					double time_ratio = elapsed_time / duration;
 
-				return;
-			}
-
-			elapsed_time = timer.elapsed_time();
+					// using apply to update all the tuples in tuple returned by twn_list()
 
-			if (elapsed_time < duration)
-			{
-				// time is not over yet so we get the time_ratio [0 - 1]
+					std::apply(
 
-				double time_ratio = elapsed_time / duration;
+						[&time_ratio](auto&... arg) constexpr noexcept
+						{
+							// current = start + difference * ease(time_ratio) [ease() function returns a number between 0 - 1]
 
-				// using apply to update all the tuples in tuple returned by twn_list()
+							(twn_step(arg, time_ratio), ...);
+						},
 
-				std::apply(
+						twn_tuple
+					);
 
-					[&time_ratio](auto&... arg) constexpr noexcept
-					{
-						// current = start + difference * ease(time_ratio) [ease() function returns a number between 0 - 1]
-
-						((std::get<0>(arg) = std::get<1>(arg) + (std::get<2>(arg) - std::get<1>(arg)) * std::get<3>(arg)(time_ratio)), ...);
-					},
+					return true;
+				}
 
-					twn_tuple
-				);
-			}
-			else
-			{
 				// duration is over so just throw in the final values
 
 				std::apply(
@@ -824,37 +839,14 @@ class bb::TWEENER : public bb::BASE_ASYNCHRONOUS_TIMER
 
 					twn_tuple
 				);
-			}
-
-			flag = true;
-
-			flag.notify_all();
-
-		} while (elapsed_time < duration);
-
-		// setting the final method before ending the thread
-
-		set_final(_final, timer.elapsed_time());
-	}
 
+				final_time = timer.elapsed_time();
 
-	public:
-
-
-	/*
-		documentation of this class explains it's usage
-	*/
-
-	template <typename... TYPE>
+				return false;
+			}, _final);
 
-	bool start(double duration, std::tuple<TYPE...> twn_list, final_func _final = nullptr) noexcept
-	{
-		if (!thread_running)
-		{
 			thread_running = true;
 
-			std::thread(&TWEENER::update<TYPE...>, this, duration, twn_list, _final).detach();
-
 			return true;
 		}
 
@@ -870,6 +862,15 @@ class bb::TWEENER : public bb::BASE_ASYNCHRONOUS_TIMER
 		return start(duration, twn_list(twn), _final);
 	}
 
+	// same, with compile time easing (see TWN_EASE in tween_accessories.h)
+
+	template <typename TYPE, double (*EASE)(double)>
+
+	bool start(double duration, std::tuple<TYPE&, TYPE, TYPE, TWN_EASE<EASE>> twn, final_func _final = nullptr) noexcept
+	{
+		return start(duration, twn_list(twn), _final);
+	}
+
 	/*
 		overloaded start() to take a twn tuple consisted of vectors of pointers and values, makes
 		it simple to deal with multiple variables of same type, more about this twn() overload in
@@ -882,6 +883,14 @@ class bb::TWEENER : public bb::BASE_ASYNCHRONOUS_TIMER
 	{
 		return start(duration, twn_list(twn), _final);
 	}
+
+
+	template <typename T, double (*EASE)(double)>
+
+	bool start(double duration, std::tuple<TWEEN_VECTOR_PTR<T>, TWEEN_VECTOR<T>, TWEEN_VECTOR<T>, TWN_EASE<EASE>> twn, final_func _final = nullptr) noexcept
+	{
+		return start(duration, twn_list(twn), _final);
+	}
 };
 
 
@@ -898,68 +907,45 @@ class bb::INTERVAL_TIMER : public bb::BASE_ASYNCHRONOUS_TIMER
 	using callback_func = std::function<bool(double)>;
 
 
-	void update(double required_delay, callback_func callback, final_func _final)
-	{
-		bool loop_continue = true;
-
-		double total_time = 0;
-
-		timer.reset();
-
-		do {
-			flag.wait(true);
-
-			if (stop_thread)
-			{
-				// break out of this thread
+	public:
 
-				thread_running = false;	// stop the update loop
 
-				thread_running.notify_all();
+	/*
+		documentation of this class explains it's usage
+	*/
 
-				return;
-			}
+	bool start(double interval_sec, callback_func callback, final_func _final = nullptr) noexcept
+	{
+		if (!thread_running)
+		{
+			timer.reset();
 
-			auto dt = timer.elapsed_time();
+			// one iteration of the update loop, run by TIMER_SCHEDULER after each unlock()
 
-			if (dt >= required_delay)
+			set_step([this, required_delay = interval_sec, callback, total_time = 0.0](double &final_time) mutable -> bool
 			{
-				// an interval
-
-				timer.reset();	// restarting the timer
-
-				total_time += dt;
-
-				loop_continue = callback(dt);
-			}
-
-			flag = true;
+				bool loop_continue = true;
 
-			flag.notify_all();
+				auto dt = timer.elapsed_time();
 
-		} while (loop_continue);
+				if (dt >= required_delay)
+				{
+					// an interval
 
-		// setting the final method before ending the thread
+					timer.reset();	// restarting the timer
 
-		set_final(_final, total_time);
-	}
+					total_time += dt;
 
+					loop_continue = callback(dt);
+				}
 
-	public:
+				final_time = total_time;
 
+				return loop_continue;
+			}, _final);
 
-	/*
-		documentation of this class explains it's usage
-	*/
-
-	bool start(double interval_sec, callback_func callback, final_func _final = nullptr) noexcept
-	{
-		if (!thread_running)
-		{
 			thread_running = true;
 
-			std::thread(&INTERVAL_TIMER::update, this, interval_sec, callback, _final).detach();
-
 			return true;
 		}
 
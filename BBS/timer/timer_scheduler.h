@@ -0,0 +1,285 @@
+#pragma once
+
+#include<thread>
+
+#include<mutex>
+
+#include<condition_variable>
+
+#include<vector>
+
+#include<algorithm>
+
+
+namespace bb
+{
+	class SCHEDULED_TIMER;
+
+	class TIMER_SCHEDULER_CLASS;
+}
+
+
+/*
+	runs the update loops of all the asynchronous timers (TWEENER, INTERVAL_TIMER, see timer.h),
+	instead of a thread for each timer.
+
+	an asynchronous timer runs one iteration of its update loop after each unlock(), unlock()
+	posts the timer to the scheduler, and the scheduler runs the iteration (step) of each posted
+	timer, in one of two modes,
+
+	WORKER (default): on a single worker thread, owned by the scheduler, created when the first
+	timer is posted (so there is no thread at all if no asynchronous timer is used).
+
+	MANUAL: on the thread that calls run(), say, the update thread,
+
+	TIMER_SCHEDULER.set_mode(TIMER_SCHEDULER_CLASS::MANUAL);
+
+	TIMER_SCHEDULER.run();	// in Update(), runs the steps posted since the last call
+
+	!!!! in MANUAL mode lock() waits till run() runs the posted step, so never call lock() (or stop())
+	!!!! of a timer on the thread that calls run() after unlock(), without a run() in between
+
+	so starting a timer costs no thread creation, and 200 tweens are 200 steps on one thread, not
+	200 threads.
+*/
+
+// a timer run by TIMER_SCHEDULER
+
+class bb::SCHEDULED_TIMER
+{
+	friend class TIMER_SCHEDULER_CLASS;
+
+
+	protected:
+
+
+	// one iteration of the update loop of the timer
+
+	virtual void run_step() noexcept = 0;
+
+
+	SCHEDULED_TIMER() = default;
+
+	~SCHEDULED_TIMER() = default;
+};
+
+
+
+class bb::TIMER_SCHEDULER_CLASS
+{
+	public:
+
+
+	enum MODE {WORKER, MANUAL};
+
+
+	private:
+
+
+	std::mutex lock;
+
+	std::condition_variable wake;	// wakes up the worker
+
+	std::condition_variable batch_done;	// signals that the steps of "running" are over
+
+	std::vector<SCHEDULED_TIMER*> ready;	// posted timers, waiting for their step
+
+	std::vector<SCHEDULED_TIMER*> running;	// timers whose steps are being run
+
+	std::thread worker;
+
+	std::thread::id runner;	// thread running the steps of "running"
+
+	MODE mode;
+
+	bool quit;	// to stop the worker
+
+
+	// runs the steps of the ready timers, "guard" is locked when called and when it returns
+
+	void run_batch(std::unique_lock<std::mutex> &guard) noexcept
+	{
+		running.swap(ready);
+
+		runner = std::this_thread::get_id();
+
+		guard.unlock();
+
+		for(size_t i = 0; i < running.size(); i++)
+		{
+			if(running[i])	// nullptr => cancelled
+			{
+				running[i]->run_step();
+			}
+		}
+
+		guard.lock();
+
+		running.clear();
+
+		runner = std::thread::id();
+
+		batch_done.notify_all();
+	}
+
+
+	void work() noexcept
+	{
+		std::unique_lock<std::mutex> guard(lock);
+
+		while(true)
+		{
+			wake.wait(guard, [this] { return quit || !ready.empty(); });
+
+			if(quit)
+			{
+				return;
+			}
+
+			run_batch(guard);
+		}
+	}
+
+
+	void stop_worker()
+	{
+		if(worker.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> guard(lock);
+
+				quit = true;
+			}
+
+			wake.notify_all();
+
+			worker.join();
+
+			quit = false;
+		}
+	}
+
+
+	public:
+
+
+	TIMER_SCHEDULER_CLASS() : mode(WORKER), quit(false)
+	{}
+
+
+	~TIMER_SCHEDULER_CLASS()
+	{
+		stop_worker();
+	}
+
+
+	TIMER_SCHEDULER_CLASS(const TIMER_SCHEDULER_CLASS&) = delete;
+
+	TIMER_SCHEDULER_CLASS& operator=(const TIMER_SCHEDULER_CLASS&) = delete;
+
+
+	// run the steps on the worker thread (WORKER) or by run() (MANUAL)
+
+	void set_mode(MODE mode_in)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+
+		mode = mode_in;
+
+		guard.unlock();
+
+		if(mode_in == MANUAL)
+		{
+			stop_worker();
+		}
+		else
+		{
+			guard.lock();
+
+			if(!ready.empty() && !worker.joinable())
+			{
+				worker = std::thread(&TIMER_SCHEDULER_CLASS::work, this);
+			}
+		}
+	}
+
+
+	MODE get_mode() noexcept
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		return mode;
+	}
+
+
+	// a timer needs a step (called by unlock())
+
+	void post(SCHEDULED_TIMER *timer)
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			ready.push_back(timer);
+
+			if(mode == WORKER && !worker.joinable())
+			{
+				worker = std::thread(&TIMER_SCHEDULER_CLASS::work, this);
+			}
+		}
+
+		wake.notify_one();
+	}
+
+
+	/*
+		drop the steps of the timer not started yet, returns true if there was any, waits for a
+		step being run on another thread to end (called by stop())
+	*/
+
+	bool cancel(SCHEDULED_TIMER *timer)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+
+		bool cancelled = std::erase(ready, timer) > 0;
+
+		if(runner == std::this_thread::get_id())
+		{
+			// called from a step, the steps of this batch are run by this thread, skip the ones of the timer
+
+			for(auto &each : running)
+			{
+				if(each == timer)
+				{
+					each = nullptr;
+
+					cancelled = true;
+				}
+			}
+		}
+		else
+		{
+			batch_done.wait(guard, [&] { return std::find(running.begin(), running.end(), timer) == running.end(); });
+		}
+
+		return cancelled;
+	}
+
+
+	// run the posted steps on this thread, in MANUAL mode (does nothing in WORKER mode)
+
+	void run() noexcept
+	{
+		std::unique_lock<std::mutex> guard(lock);
+
+		if(mode == MANUAL && !ready.empty() && runner == std::thread::id())
+		{
+			run_batch(guard);
+		}
+	}
+};
+
+
+namespace bb
+{
+	inline TIMER_SCHEDULER_CLASS TIMER_SCHEDULER;	// runs all the asynchronous timers of the game engine
+}
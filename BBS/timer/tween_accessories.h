@@ -8,6 +8,12 @@
 
 #include<functional>
 
+#include<vector>
+
+#include<stdexcept>
+
+#include"../utility/counting_allocator.h"	// to count the allocations of TWEEN_VECTOR
+
 
 namespace bb {	
 
@@ -339,6 +345,80 @@ auto twn(TYPE& data, TYPE start, TYPE end, TWN_TYPE::func ease = nullptr) noexce
 }
 
 
+/*
+	compile time easing:-
+
+	TWN_TYPE::func is a std::function, calling it for each step of a tween is an indirect call
+	that can't be inlined, for the easing functions known at compile time, pass the easing as a
+	template argument instead,
+
+	twn<TWN_TYPE::in_quad>(x, 0.0f, 100.0f);
+
+	twn<TWN_TYPE::out_bounce>(y, 50.0f);	// from the current value
+
+	or as a tag argument (handy with the vector twn() overloads below, whose first template argument
+	is the type of the values),
+
+	twn(x, 0.0f, 100.0f, TWN_EASE<TWN_TYPE::in_quad>{});
+
+	the tuple holds a TWN_EASE<> instead of a TWN_TYPE::func, it's an empty object whose call is
+	inlined in the update loop of TWEENER, pass these tuples to TWEENER::start() or twn_list() as
+	usual, they can be mixed with the tuples having a TWN_TYPE::func (any custom curve, even a lambda
+	capturing some state, still needs the std::function version).
+*/
+
+template <double (*EASE)(double)>
+
+struct TWN_EASE
+{
+	double operator()(double x) const noexcept
+	{
+		return EASE(x);
+	}
+};
+
+
+template <typename TYPE, double (*EASE)(double)>
+
+auto twn(TYPE& data, TYPE end, TWN_EASE<EASE> ease) noexcept
+{
+	// assuming that data is already initialized
+
+	return std::tuple<TYPE&, TYPE, TYPE, TWN_EASE<EASE>>(
+		data	/*ref*/,
+		data	/*initial value*/,
+		end		/*end value*/,
+		ease	/*easing function*/
+	);
+}
+
+
+template <typename TYPE, double (*EASE)(double)>
+
+auto twn(TYPE& data, TYPE start, TYPE end, TWN_EASE<EASE> ease) noexcept
+{
+	data = start;	// initialize data with start
+
+	return twn(data, end, ease);
+}
+
+
+template <double (*EASE)(double), typename TYPE>
+
+auto twn(TYPE& data, TYPE end) noexcept
+{
+	return twn(data, end, TWN_EASE<EASE>{});
+}
+
+
+template <double (*EASE)(double), typename TYPE>
+
+auto twn(TYPE& data, TYPE start, TYPE end) noexcept
+{
+	return twn(data, start, end, TWN_EASE<EASE>{});
+}
+
+
 /*
 	This function accepts several tuples created by twn() and combines them into a
 	single tuple of tuples
@@ -359,9 +439,26 @@ auto twn_list(TYPE... twn_tuple) noexcept
 
 	This way I want to tween multiple values of same type at once and we don't have to
 	know the exact number of variables to tween at compile time
+
+	the arithmetic operators create a new vector for each result, so TWEENER doesn't use them,
+	it calls TWEEN_VECTOR_PTR::tween(), which computes start + (end - start) * ease for all the
+	variables in one pass, with no allocation (see twn_step() below)
+
+	the vectors of these classes count their allocations,
+
+	size_t before = TWN_ALLOCATION_COUNTER::allocations();
+
+	// ... update loop of a tween
+
+	TWN_ALLOCATION_COUNTER::allocations() - before;	// 0, the allocations are made only by twn() and start()
 */
 
 
+struct TWN_ALLOCATIONS;	// tag of the allocations of TWEEN_VECTOR and TWEEN_VECTOR_PTR
+
+using TWN_ALLOCATION_COUNTER = ALLOCATION_COUNTER<TWN_ALLOCATIONS>;
+
+
 // declaring TWEEN_VECTOR_PTR class so that we can make it a friend of TWEEN_VECTOR class
 
 template<typename T>
@@ -379,17 +476,22 @@ template<typename T>
 class TWEEN_VECTOR
 {
 
-	std::vector<T> data;
+	using storage = std::vector<T, COUNTING_ALLOCATOR<T, TWN_ALLOCATIONS>>;
+
+	storage data;
 
 	friend class TWEEN_VECTOR_PTR<T>;
 
 
+	TWEEN_VECTOR(storage&& vec) noexcept : data(std::move(vec)) {}
+
+
 public:
 
 	
 	// Constructor
 
-	TWEEN_VECTOR(const std::vector<T>& vec) : data(vec) {}
+	TWEEN_VECTOR(const std::vector<T>& vec) : data(vec.begin(), vec.end()) {}
 
 	
 	// Arithmetic operators (TWEEN_VECTOR op TWEEN_VECTOR) (element-wise)
@@ -446,7 +548,7 @@ private:
 			throw std::invalid_argument("Vector sizes must match for arithmetic");
 		}
 
-		std::vector<T> result;
+		storage result;
 
 		result.reserve(data.size());
 
@@ -455,7 +557,7 @@ private:
 			result.push_back(op(data[i], other.data[i]));
 		}
 
-		return TWEEN_VECTOR(result);
+		return TWEEN_VECTOR(std::move(result));
 	}
 
 
@@ -465,7 +567,7 @@ private:
 
 	TWEEN_VECTOR elementwise_op(double value, Op op) const
 	{
-		std::vector<T> result;
+		storage result;
 
 		result.reserve(data.size());
 
@@ -474,7 +576,7 @@ private:
 			result.push_back(op((double)data[i], value));
 		}
 
-		return TWEEN_VECTOR(result);
+		return TWEEN_VECTOR(std::move(result));
 	}
 };
 
@@ -489,7 +591,7 @@ template <typename T>
 class TWEEN_VECTOR_PTR
 {
 
-	std::vector<T*> data;
+	std::vector<T*, COUNTING_ALLOCATOR<T*, TWN_ALLOCATIONS>> data;
 
 
 public:
@@ -497,7 +599,7 @@ public:
 
 	// constructor
 
-	TWEEN_VECTOR_PTR(const std::vector<T*>& vec) : data(vec) {}
+	TWEEN_VECTOR_PTR(const std::vector<T*>& vec) : data(vec.begin(), vec.end()) {}
 
 	// Assignment from TWEEN_VECTOR<T>
 
@@ -518,9 +620,57 @@ public:
 			*data[i] = source.data[i];
 		}
 	}
+
+
+	/*
+		*pointer[i] = start[i] + (end[i] - start[i]) * eased, for all the variables in one pass
+		over the vectors, no temporary vector, so no allocation
+	*/
+
+	void tween(const TWEEN_VECTOR<T>& start, const TWEEN_VECTOR<T>& end, double eased) const
+	{
+		if (data.size() != start.data.size() || data.size() != end.data.size())
+		{
+			throw std::invalid_argument("Vector sizes must match for arithmetic");
+		}
+
+		T* const *pointer = data.data();
+
+		const T *from = start.data.data(), *to = end.data.data();
+
+		for(size_t i = 0; i < data.size(); i++)
+		{
+			*pointer[i] = from[i] + (to[i] - from[i]) * eased;
+		}
+	}
 };
 
 
+/*
+	one step of a tween tuple (made by twn()), used by TWEENER,
+
+	variable = start + (end - start) * ease(time_ratio)
+
+	the vector tuples use the fused TWEEN_VECTOR_PTR::tween(), instead of the arithmetic operators
+	of TWEEN_VECTOR, which allocate
+*/
+
+template <typename TUPLE>
+
+void twn_step(TUPLE& twn, double time_ratio)
+{
+	std::get<0>(twn) = std::get<1>(twn) + (std::get<2>(twn) - std::get<1>(twn)) * std::get<3>(twn)(time_ratio);
+}
+
+
+template <typename T, typename EASE>
+
+void twn_step(std::tuple<TWEEN_VECTOR_PTR<T>, TWEEN_VECTOR<T>, TWEEN_VECTOR<T>, EASE>& twn, double time_ratio)
+{
+	std::get<0>(twn).tween(std::get<1>(twn), std::get<2>(twn), std::get<3>(twn)(time_ratio));
+}
+
+
 /*
 	following two functions are overloaded versions of twn() that take
 
@@ -604,6 +754,39 @@ auto twn(const std::vector<T*>& data, const std::vector<T>& end, TWN_TYPE::func
 
 
 
+// same as above, with compile time easing
+
+template <typename T, double (*EASE)(double)>
+
+auto twn(const std::vector<T*>& data, const std::vector<T>& start, const std::vector<T>& end, TWN_EASE<EASE> ease) noexcept
+{
+	return std::tuple<TWEEN_VECTOR_PTR<T>, TWEEN_VECTOR<T>, TWEEN_VECTOR<T>, TWN_EASE<EASE>>(
+		TWEEN_VECTOR_PTR<T>{ data }	/*pointers*/,
+		TWEEN_VECTOR<T>{ start }	/*initial value*/,
+		TWEEN_VECTOR<T>{ end }		/*end value*/,
+		ease						/*easing function*/
+	);
+}
+
+
+template <typename T, double (*EASE)(double)>
+
+auto twn(const std::vector<T*>& data, const std::vector<T>& end, TWN_EASE<EASE> ease) noexcept
+{
+	std::vector<T> start(data.size());
+
+	// store current values of pointers as initial values
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		start[i] = *data[i];
+	}
+
+	return twn(data, start, end, ease);
+}
+
+
+
 /*
 	this class is used to help with tweening multiple variables of same type at once
 
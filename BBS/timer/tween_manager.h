@@ -0,0 +1,451 @@
+#pragma once
+
+#include<vector>
+
+#include<memory>
+
+#include<functional>
+
+#include<unordered_map>
+
+#include<algorithm>
+
+#include<cstdint>
+
+#include"tween_accessories.h"	// TWN_TYPE
+
+#include"easing_batch.h"	// TWN_BATCH, to ease a group at once
+
+
+namespace bb
+{
+	struct TWEEN_HANDLE;
+
+	class TWEEN_MANAGER;
+}
+
+
+
+/*
+	TWEEN_MANAGER runs thousands of tweens at once, say, the positions and colors of all the
+	sprites and buttons of a menu, where a TWEENER (see timer.h) for each would be too costly.
+
+	It's not an asynchronous timer, like DELAY_TIMER, call its update(dt) from Update() and it
+	updates all the tweens, no thread, no lock() - unlock().
+
+	how to use:-
+
+	TWEEN_MANAGER tweens;
+
+	// tween x from 0 to 100 in 0.5 seconds, with out_quad easing, the easing is a template argument
+
+	TWEEN_HANDLE handle = tweens.add<TWN_TYPE::out_quad>(x, 0.0f, 100.0f, 0.5);
+
+	tweens.add(alpha, (uint8_t)255, 1.0, [](double dt) { ... });	// from the current value, linear, with a final callback
+
+	tweens.update(dt);	// in Update(), updates the variables, calls the final callbacks of the finished tweens
+
+	tweens.is_running(handle);
+
+	tweens.stop(handle);	// stop it, the variable keeps its current value, final callback isn't called
+
+	the handle stays valid (and refers to the same tween) till the tween finishes or is stopped,
+	after that is_running() returns false and stop() does nothing, even if the memory of the tween
+	is used by a new one.
+
+	~~~~ Caution: ~~~~
+
+	the variables are written by update(), through pointers, keep them alive (and at the same address)
+	till their tweens finish or are stopped.
+
+	**********************************
+	Let me describe it's inner working
+	**********************************
+
+	the tweens are grouped by the type of the variable and the easing function, each group stores its
+	tweens in arrays (structure of arrays),
+
+	target		: [ &x  ][ &y  ][ &z  ]...
+	start		: [  0  ][  5  ][ 10  ]...
+	end			: [ 100 ][ 50  ][ 20  ]...
+	progress	: [ 0.2 ][ 0.7 ][ 1.0 ]...	elapsed time / duration
+	rate		: [  2  ][  4  ][  1  ]...	1 / duration
+
+	update() makes one pass over each array of each group, the easing function is known at compile time
+	so it's inlined in the loop, no std::function call for each tween, and the loops over progress and
+	rate are vectorized by the compiler, the progress values of a group are eased at once with
+	TWN_BATCH (see easing_batch.h).
+
+	then the finished tweens are removed from their groups, the last tween of the group takes the place of
+	the removed one (so the arrays stay packed), a table of slots maps each handle to the current place of
+	its tween, the handles don't change when the tweens move.
+*/
+
+struct bb::TWEEN_HANDLE
+{
+	uint32_t slot = UINT32_MAX;
+
+	uint32_t generation = 0;	// changes when the slot is reused, so old handles become invalid
+};
+
+
+
+class bb::TWEEN_MANAGER
+{
+	public:
+
+
+	using final_func = std::function<void(double)>;
+
+
+	private:
+
+
+	// the place of a tween, group is FREE if the slot isn't used
+
+	struct SLOT
+	{
+		uint32_t group, index, generation;
+	};
+
+
+	static constexpr uint32_t FREE = UINT32_MAX;
+
+
+	// the parts of a group that don't depend on the type of the variable or the easing
+
+	struct BASE_GROUP
+	{
+		std::vector<double> progress, rate;
+
+		std::vector<uint32_t> slot;	// slot of each tween
+
+		std::vector<final_func> finals;
+
+
+		virtual ~BASE_GROUP() = default;
+
+
+		// ease the progress and write the values into the variables
+
+		virtual void apply() noexcept = 0;
+
+
+		// remove the tween at index, the last one takes its place
+
+		virtual void remove(size_t index) noexcept = 0;
+
+
+		// returns true if any tween finished
+
+		bool advance(double dt) noexcept
+		{
+			bool done = false;
+
+			for(size_t i = 0; i < progress.size(); i++)
+			{
+				progress[i] = std::min(progress[i] + dt * rate[i], 1.0);
+
+				done |= progress[i] >= 1.0;
+			}
+
+			return done;
+		}
+
+
+		void remove_base(size_t index) noexcept
+		{
+			progress[index] = progress.back();
+
+			rate[index] = rate.back();
+
+			slot[index] = slot.back();
+
+			finals[index] = std::move(finals.back());
+
+			progress.pop_back();
+
+			rate.pop_back();
+
+			slot.pop_back();
+
+			finals.pop_back();
+		}
+	};
+
+
+	template<typename T, double (*EASE)(double)>
+
+	struct GROUP : BASE_GROUP
+	{
+		std::vector<T*> target;
+
+		std::vector<T> start, end;
+
+		std::vector<double> eased;	// eased progress, a value for each tween, set by apply()
+
+
+		void apply() noexcept override
+		{
+			TWN_BATCH::ease<EASE>(progress.data(), eased.data(), progress.size());
+
+			for(size_t i = 0; i < target.size(); i++)
+			{
+				// current = start + difference * ease(progress), as TWEENER does, and end when it's over
+
+				*target[i] = (progress[i] < 1.0) ? start[i] + (end[i] - start[i]) * eased[i] : end[i];
+			}
+		}
+
+
+		void remove(size_t index) noexcept override
+		{
+			target[index] = target.back();
+
+			start[index] = start.back();
+
+			end[index] = end.back();
+
+			target.pop_back();
+
+			eased.pop_back();
+
+			start.pop_back();
+
+			end.pop_back();
+
+			remove_base(index);
+		}
+	};
+
+
+	// a tween that finished in this update, its final callback is called after all the groups are updated
+
+	struct FINISHED
+	{
+		final_func final;
+
+		double duration;
+	};
+
+
+	std::vector<std::unique_ptr<BASE_GROUP>> groups;
+
+	std::unordered_map<const void*, uint32_t> group_index;	// address of GROUP<T, EASE>::key -> index in groups
+
+	std::vector<SLOT> slots;
+
+	std::vector<uint32_t> free_slots;
+
+	std::vector<FINISHED> finished;
+
+	size_t tween_count = 0;
+
+
+	// a unique address for each GROUP<T, EASE>
+
+	template<typename T, double (*EASE)(double)>
+
+	inline static const char key = 0;
+
+
+	template<typename T, double (*EASE)(double)>
+
+	GROUP<T, EASE>& group(uint32_t &index)
+	{
+		auto [it, inserted] = group_index.try_emplace(&key<T, EASE>, (uint32_t)groups.size());
+
+		if(inserted)
+		{
+			groups.push_back(std::make_unique<GROUP<T, EASE>>());
+		}
+
+		index = it->second;
+
+		return static_cast<GROUP<T, EASE>&>(*groups[index]);
+	}
+
+
+	void free_slot(uint32_t slot) noexcept
+	{
+		slots[slot].group = FREE;
+
+		slots[slot].generation++;
+
+		free_slots.push_back(slot);
+
+		tween_count--;
+	}
+
+
+	public:
+
+
+	/*
+		tween "data" from start to end in "duration" seconds, with the easing function EASE (a function
+		of TWN_TYPE or any double(double) function), final(duration) is called by update() when it ends
+	*/
+
+	template<double (*EASE)(double) = TWN_TYPE::linear, typename T>
+
+	TWEEN_HANDLE add(T &data, T start, T end, double duration, final_func final = nullptr)
+	{
+		uint32_t index;
+
+		GROUP<T, EASE> &tweens = group<T, EASE>(index);
+
+		uint32_t slot;
+
+		if(free_slots.empty())
+		{
+			slot = (uint32_t)slots.size();
+
+			slots.push_back({FREE, 0, 0});
+		}
+		else
+		{
+			slot = free_slots.back();
+
+			free_slots.pop_back();
+		}
+
+		slots[slot].group = index;
+
+		slots[slot].index = (uint32_t)tweens.target.size();
+
+		tweens.target.push_back(&data);
+
+		tweens.start.push_back(start);
+
+		tweens.end.push_back(end);
+
+		tweens.eased.push_back(0.0);
+
+		// a tween with no duration finishes in the next update
+
+		tweens.progress.push_back(duration > 0 ? 0.0 : 1.0);
+
+		tweens.rate.push_back(duration > 0 ? 1.0 / duration : 0.0);
+
+		tweens.slot.push_back(slot);
+
+		tweens.finals.push_back(std::move(final));
+
+		data = start;
+
+		tween_count++;
+
+		return {slot, slots[slot].generation};
+	}
+
+
+	// from the current value of data
+
+	template<double (*EASE)(double) = TWN_TYPE::linear, typename T>
+
+	TWEEN_HANDLE add(T &data, T end, double duration, final_func final = nullptr)
+	{
+		return add<EASE>(data, T(data), end, duration, std::move(final));
+	}
+
+
+	/*
+		updates all the tweens, then calls the final callbacks of the ones that finished, the final
+		callbacks can add new tweens or stop the others
+	*/
+
+	void update(double dt)
+	{
+		for(auto &tweens : groups)
+		{
+			bool done = tweens->advance(dt);
+
+			tweens->apply();
+
+			// removing the finished tweens, from the back, so the tween moved in is already checked
+
+			for(size_t i = done ? tweens->progress.size() : 0; i-- > 0;)
+			{
+				if(tweens->progress[i] >= 1.0)
+				{
+					if(tweens->finals[i])
+					{
+						finished.push_back({std::move(tweens->finals[i]), tweens->rate[i] ? 1.0 / tweens->rate[i] : 0.0});
+					}
+
+					free_slot(tweens->slot[i]);
+
+					tweens->remove(i);
+
+					if(i < tweens->slot.size())
+					{
+						slots[tweens->slot[i]].index = (uint32_t)i;
+					}
+				}
+			}
+		}
+
+		for(size_t i = 0; i < finished.size(); i++)
+		{
+			finished[i].final(finished[i].duration);
+		}
+
+		finished.clear();
+	}
+
+
+	bool is_running(TWEEN_HANDLE handle) const noexcept
+	{
+		return handle.slot < slots.size() && slots[handle.slot].group != FREE && slots[handle.slot].generation == handle.generation;
+	}
+
+
+	// stop the tween without calling its final callback, the variable keeps its current value
+
+	void stop(TWEEN_HANDLE handle) noexcept
+	{
+		if(!is_running(handle))
+		{
+			return;
+		}
+
+		SLOT place = slots[handle.slot];
+
+		BASE_GROUP &tweens = *groups[place.group];
+
+		free_slot(handle.slot);
+
+		tweens.remove(place.index);
+
+		if(place.index < tweens.slot.size())
+		{
+			slots[tweens.slot[place.index]].index = place.index;
+		}
+	}
+
+
+	// stop all the tweens
+
+	void clear() noexcept
+	{
+		groups.clear();
+
+		group_index.clear();
+
+		for(uint32_t slot = 0; slot < slots.size(); slot++)
+		{
+			if(slots[slot].group != FREE)
+			{
+				free_slot(slot);
+			}
+		}
+	}
+
+
+	// no. of running tweens
+
+	size_t size() const noexcept
+	{
+		return tween_count;
+	}
+};
@@ -0,0 +1,262 @@
+#pragma once
+
+#include<vector>
+
+#include<cstring>
+
+#include<cstddef>
+
+#include<cstdint>
+
+#include<type_traits>
+
+
+namespace bb
+{
+	class BINARY_WRITER;
+
+	class BINARY_READER;
+}
+
+
+/*
+	BINARY_WRITER writes values into a byte buffer (std::vector<char>), BINARY_READER reads them
+	back from any block of memory (a buffer, a file read in memory or a memory mapped file), used
+	to save and load the ECS (see entity_component_system.h), but works for anything.
+
+	how to use:-
+
+	std::vector<char> buffer;
+
+	BINARY_WRITER writer(buffer);
+
+	writer.write(score);	// a trivially copyable value, its bytes are copied as they are
+
+	writer.write_array(positions.data(), positions.size());	// one memcpy for the whole array
+
+	BINARY_READER reader(buffer.data(), buffer.size());
+
+	reader.read(score);
+
+	reader.read_array(positions.data(), positions.size());
+
+	if(!reader.ok()) { ... }	// the data ended before all the values were read
+
+	the values are written in the byte order of the machine, so a buffer should be read on the
+	same kind of machine (which is the case for save games, rollback and crash dumps).
+
+	non trivially copyable types:-
+
+	a type that can't be copied byte by byte (say, it holds a std::string) needs two functions,
+	found by ADL (put them in the namespace of the type), used for each value of the type,
+
+	struct NAME { std::string text; };
+
+	void write_binary(bb::BINARY_WRITER &writer, const NAME &name)
+	{
+		writer.write(name.text.size());
+
+		writer.write_array(name.text.data(), name.text.size());
+	}
+
+	void read_binary(bb::BINARY_READER &reader, NAME &name)
+	{
+		size_t size = 0;
+
+		reader.read(size);
+
+		name.text.resize(reader.ok() ? size : 0);
+
+		reader.read_array(name.text.data(), name.text.size());
+	}
+
+	!!!! a reader doesn't copy the memory, keep it alive while reading
+*/
+
+class bb::BINARY_WRITER
+{
+	std::vector<char> &buffer;
+
+
+	public:
+
+
+	// the values are appended to the buffer
+
+	explicit BINARY_WRITER(std::vector<char> &buffer_in) noexcept : buffer(buffer_in)
+	{}
+
+
+	void write_bytes(const void *data, size_t bytes)
+	{
+		size_t offset = buffer.size();
+
+		buffer.resize(offset + bytes);
+
+		if(bytes)
+		{
+			std::memcpy(buffer.data() + offset, data, bytes);
+		}
+	}
+
+
+	template<typename T>
+
+	void write(const T &value)
+	{
+		write_array(&value, 1);
+	}
+
+
+	// trivially copyable arrays are written with a single copy, others value by value with write_binary()
+
+	template<typename T>
+
+	void write_array(const T *values, size_t count)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			write_bytes(values, sizeof(T) * count);
+		}
+		else
+		{
+			static_assert(
+
+				requires(BINARY_WRITER &writer, const T &value) { write_binary(writer, value); },
+
+				"!!!! write_binary(BINARY_WRITER&, const T&) is required for a non trivially copyable type !!!!"
+			);
+
+			for(size_t i = 0; i < count; i++)
+			{
+				write_binary(*this, values[i]);
+			}
+		}
+	}
+
+
+	// pad with zeros till the size is a multiple of "alignment"
+
+	void align(size_t alignment)
+	{
+		buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, 0);
+	}
+
+
+	size_t size() const noexcept
+	{
+		return buffer.size();
+	}
+};
+
+
+
+class bb::BINARY_READER
+{
+	const char *data;
+
+	size_t size, offset;
+
+	bool failed;
+
+
+	public:
+
+
+	BINARY_READER(const void *data_in, size_t size_in) noexcept : data((const char*)data_in), size(size_in), offset(0), failed(false)
+	{}
+
+
+	// pointer to the next "bytes" bytes, nullptr if there aren't enough bytes left (then the reader fails)
+
+	const char* read_bytes(size_t bytes) noexcept
+	{
+		if(failed || size - offset < bytes)
+		{
+			failed = true;
+
+			return nullptr;
+		}
+
+		const char *bytes_read = data + offset;
+
+		offset += bytes;
+
+		return bytes_read;
+	}
+
+
+	template<typename T>
+
+	void read(T &value)
+	{
+		read_array(&value, 1);
+	}
+
+
+	// trivially copyable arrays are read with a single copy, others value by value with read_binary()
+
+	template<typename T>
+
+	void read_array(T *values, size_t count)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			if(count > (size - offset) / sizeof(T))
+			{
+				failed = true;
+			}
+
+			if(const char *bytes = read_bytes(sizeof(T) * count); bytes && count)
+			{
+				std::memcpy((void*)values, bytes, sizeof(T) * count);
+			}
+		}
+		else
+		{
+			static_assert(
+
+				requires(BINARY_READER &reader, T &value) { read_binary(reader, value); },
+
+				"!!!! read_binary(BINARY_READER&, T&) is required for a non trivially copyable type !!!!"
+			);
+
+			for(size_t i = 0; i < count && !failed; i++)
+			{
+				read_binary(*this, values[i]);
+			}
+		}
+	}
+
+
+	// skip the padding written by BINARY_WRITER::align()
+
+	void align(size_t alignment) noexcept
+	{
+		size_t padding = (alignment - offset % alignment) % alignment;
+
+		read_bytes(padding);
+	}
+
+
+	// false if the data ended before all the values were read (or a read function called fail())
+
+	bool ok() const noexcept
+	{
+		return !failed;
+	}
+
+
+	void fail() noexcept
+	{
+		failed = true;
+	}
+
+
+	// no. of bytes not read yet
+
+	size_t remaining() const noexcept
+	{
+		return size - offset;
+	}
+};
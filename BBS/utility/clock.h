@@ -0,0 +1,246 @@
+#pragma once
+
+#include<chrono>
+
+#include<atomic>
+
+#include<mutex>
+
+#include<thread>
+
+#include<algorithm>
+
+
+namespace bb
+{
+	class CLOCK_CLASS;
+}
+
+
+/*
+	this is the clock of the whole game engine, FPS_CONTROL, TIMER (and so all the asynchronous
+	timers) and GAME_LOOP read the time from the predefined object CLOCK instead of reading
+	std::chrono::steady_clock directly, so the time of the whole engine can be slowed down,
+	sped up or even controlled manually.
+
+	modes:-
+
+	REAL (default), the clock runs with the real time
+
+	CLOCK.set_real();
+
+	SCALED, the clock runs "scale" times faster than the real time (0.5 => half speed, 2 => double)
+
+	CLOCK.set_scale(50);
+
+	MANUAL, the clock stands still, it moves only when it's stepped, either by step() or by the frame
+	pacer (FPS_CONTROL), which doesn't wait for the next frame, instead it fast-forwards the clock to it,
+	so the game runs as fast as possible, yet each frame is exactly 1 / fps seconds long.
+
+	CLOCK.set_manual();	// continue from current time
+
+	CLOCK.set_manual(0);	// start from time 0
+
+	CLOCK.step(0.5);	// move the clock forward by 0.5 seconds
+
+	deterministic replay:-
+
+	in MANUAL mode the time seen by the game depends only on the fps, ups and the steps, not on how
+	long anything takes, so with the same inputs the game produces bit-identical results, run after
+	run, no matter how fast. to get identical floating point times in each run, start the clock from
+	a fixed time, like set_manual(0), before the game starts (say, in Create()) and keep the update
+	and render loops in LOCKSTEP (the default) mode.
+
+	how it works:-
+
+	virtual time = base_virtual + (real time - base_real) * scale
+
+	REAL => scale 1, MANUAL => scale 0, each change of mode or scale moves the bases to current time,
+	so the clock never jumps, step() adds to base_virtual.
+
+	the bases and scale are read together with a sequence lock (a counter that is odd while they are
+	being written), so now() never locks.
+
+	!!!! changing the mode (specially set_manual(start)) while timers are running can make them jump,
+	!!!! better select the mode before the game starts
+*/
+
+class bb::CLOCK_CLASS
+{
+	public:
+
+
+	using duration = std::chrono::duration<double>;	// represents duration in seconds using double
+
+	using time_point = std::chrono::time_point<std::chrono::steady_clock, duration>;
+
+
+	private:
+
+
+	std::atomic<unsigned> version;	// odd => bases are being written
+
+	std::atomic<double> base_real, base_virtual, scale;	// in seconds
+
+	std::mutex write_lock;	// to allow only one writer at a time
+
+
+	static double real_seconds() noexcept
+	{
+		return std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+
+	// set the bases and scale under the sequence lock, virtual(current) gives the new base_virtual
+
+	template<typename FUNC>
+
+	void rebase(double new_scale, FUNC virtual_from) noexcept
+	{
+		std::lock_guard<std::mutex> guard(write_lock);
+
+		double real = real_seconds();
+
+		double current = base_virtual.load(std::memory_order_relaxed) + (real - base_real.load(std::memory_order_relaxed)) * scale.load(std::memory_order_relaxed);
+
+		version.fetch_add(1, std::memory_order_acq_rel);
+
+		base_virtual.store(virtual_from(current), std::memory_order_relaxed);
+
+		base_real.store(real, std::memory_order_relaxed);
+
+		scale.store(new_scale, std::memory_order_relaxed);
+
+		version.fetch_add(1, std::memory_order_release);
+	}
+
+
+	public:
+
+
+	constexpr CLOCK_CLASS() : version(0), base_real(0), base_virtual(0), scale(1)
+	{}
+
+
+	// current time of the clock in seconds
+
+	double seconds() const noexcept
+	{
+		double virtual_time;
+
+		unsigned begin;
+
+		do{
+			begin = version.load(std::memory_order_acquire);
+
+			double real = real_seconds();
+
+			virtual_time = base_virtual.load(std::memory_order_relaxed) + (real - base_real.load(std::memory_order_relaxed)) * scale.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+		}while((begin & 1) || begin != version.load(std::memory_order_relaxed));
+
+		return virtual_time;
+	}
+
+
+	// current time of the clock as a time point
+
+	time_point now() const noexcept
+	{
+		return time_point(duration(seconds()));
+	}
+
+
+	void set_real() noexcept
+	{
+		rebase(1, [](double current) { return current; });
+	}
+
+
+	void set_scale(double new_scale) noexcept
+	{
+		rebase(std::max(new_scale, 0.0), [](double current) { return current; });
+	}
+
+
+	void set_manual() noexcept
+	{
+		rebase(0, [](double current) { return current; });
+	}
+
+
+	void set_manual(double start) noexcept
+	{
+		rebase(0, [start](double) { return start; });
+	}
+
+
+	double get_scale() const noexcept
+	{
+		return scale;
+	}
+
+
+	bool is_manual() const noexcept
+	{
+		return scale == 0;
+	}
+
+
+	// move the clock forward (works in any mode)
+
+	void step(double seconds) noexcept
+	{
+		double current_scale = scale;
+
+		rebase(current_scale, [seconds](double current) { return current + seconds; });
+	}
+
+
+	/*
+		in MANUAL mode, moves the clock to the given time (if it's ahead) and returns true,
+		in other modes it does nothing and returns false, the caller must wait for the time
+	*/
+
+	bool fast_forward(time_point target) noexcept
+	{
+		if(!is_manual())
+		{
+			return false;
+		}
+
+		double seconds = target.time_since_epoch().count();
+
+		rebase(0, [seconds](double current) { return std::max(current, seconds); });
+
+		return true;
+	}
+
+
+	/*
+		sleep for the given duration of clock time, in SCALED mode the real sleep is shorter
+		or longer, in MANUAL mode it simply moves the clock forward
+	*/
+
+	void sleep_for(double seconds) noexcept
+	{
+		double current_scale = scale;
+
+		if(current_scale == 0)
+		{
+			step(seconds);
+		}
+		else
+		{
+			std::this_thread::sleep_for(duration(seconds / current_scale));
+		}
+	}
+};
+
+
+namespace bb
+{
+	inline CLOCK_CLASS CLOCK;	// the clock of the whole game engine
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include<memory>
+
+#include<atomic>
+
+#include<cstddef>
+
+
+namespace bb
+{
+	template<typename TAG>
+
+	struct ALLOCATION_COUNTER;
+
+	template<typename T, typename TAG>
+
+	struct COUNTING_ALLOCATOR;
+}
+
+
+/*
+	an allocator for std::vector (or any container) that counts its allocations, to prove
+	that some code doesn't allocate, or to find the one that does.
+
+	the counts are kept per TAG, a type used only as a name, all the containers using the
+	same TAG (whatever their element types) add to the same ALLOCATION_COUNTER<TAG>,
+
+	struct PARTICLE_MEMORY;	// the tag
+
+	std::vector<float, COUNTING_ALLOCATOR<float, PARTICLE_MEMORY>> x, y;
+
+	size_t before = ALLOCATION_COUNTER<PARTICLE_MEMORY>::allocations();
+
+	// ... the code that shouldn't allocate
+
+	assert(ALLOCATION_COUNTER<PARTICLE_MEMORY>::allocations() == before);
+
+	the counters are relaxed atomics, so the containers can be used by many threads, and cost
+	almost nothing next to the allocation itself.
+
+	TWEEN_VECTOR and TWEEN_VECTOR_PTR use it (see timer/tween_accessories.h).
+*/
+
+template<typename TAG>
+
+struct bb::ALLOCATION_COUNTER
+{
+	inline static std::atomic<size_t> allocation_count = 0, deallocation_count = 0, byte_count = 0;
+
+
+	// no. of allocations made
+
+	static size_t allocations() noexcept
+	{
+		return allocation_count.load(std::memory_order_relaxed);
+	}
+
+
+	// no. of allocations freed
+
+	static size_t deallocations() noexcept
+	{
+		return deallocation_count.load(std::memory_order_relaxed);
+	}
+
+
+	// total bytes allocated
+
+	static size_t bytes() noexcept
+	{
+		return byte_count.load(std::memory_order_relaxed);
+	}
+
+
+	static void reset() noexcept
+	{
+		allocation_count = 0;
+
+		deallocation_count = 0;
+
+		byte_count = 0;
+	}
+};
+
+
+
+template<typename T, typename TAG>
+
+struct bb::COUNTING_ALLOCATOR : std::allocator<T>
+{
+	template<typename U>
+
+	struct rebind
+	{
+		using other = COUNTING_ALLOCATOR<U, TAG>;
+	};
+
+
+	COUNTING_ALLOCATOR() = default;
+
+
+	template<typename U>
+
+	COUNTING_ALLOCATOR(const COUNTING_ALLOCATOR<U, TAG>&) noexcept
+	{}
+
+
+	T* allocate(size_t count)
+	{
+		ALLOCATION_COUNTER<TAG>::allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+		ALLOCATION_COUNTER<TAG>::byte_count.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+
+		return std::allocator<T>::allocate(count);
+	}
+
+
+	void deallocate(T *pointer, size_t count) noexcept
+	{
+		ALLOCATION_COUNTER<TAG>::deallocation_count.fetch_add(1, std::memory_order_relaxed);
+
+		std::allocator<T>::deallocate(pointer, count);
+	}
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include<memory>
+
+#include<new>
+
+#include<utility>
+
+#include<type_traits>
+
+
+namespace bb
+{
+	template<typename T>
+
+	struct DEFAULT_INIT_ALLOCATOR;
+}
+
+
+/*
+	an allocator for std::vector that default-initializes the new elements instead of
+	value-initializing them, so resize() of a vector of int, double, float or a plain struct
+	of them doesn't fill the new elements with zeros, it only allocates (and copies the old
+	elements), the new elements hold garbage till they are set.
+
+	the types with a default constructor (say, sf::Vertex) are still constructed as usual,
+	only the zero filling of the trivial types is skipped.
+
+	how to use:-
+
+	std::vector<double, DEFAULT_INIT_ALLOCATOR<double>> values;
+
+	values.resize(1000000);	// no 8 MB of zeros written
+
+	values.resize(10, 0.0);	// elements constructed with a value are set as usual
+
+	ENTITY_COMPONENT_SYSTEM stores its components in such vectors (see entity_component_system.h),
+	as each component of a new entity is set by the user anyway.
+*/
+
+template<typename T>
+
+struct bb::DEFAULT_INIT_ALLOCATOR : std::allocator<T>
+{
+	template<typename U>
+
+	struct rebind
+	{
+		using other = DEFAULT_INIT_ALLOCATOR<U>;
+	};
+
+
+	DEFAULT_INIT_ALLOCATOR() = default;
+
+
+	template<typename U>
+
+	DEFAULT_INIT_ALLOCATOR(const DEFAULT_INIT_ALLOCATOR<U>&) noexcept
+	{}
+
+
+	// no arguments, default-initialize (no zero filling)
+
+	template<typename U>
+
+	void construct(U *pointer) noexcept(std::is_nothrow_default_constructible_v<U>)
+	{
+		::new((void*)pointer) U;
+	}
+
+
+	// with arguments, construct as usual
+
+	template<typename U, typename... ARGS>
+
+	void construct(U *pointer, ARGS&&... args)
+	{
+		::new((void*)pointer) U(std::forward<ARGS>(args)...);
+	}
+};
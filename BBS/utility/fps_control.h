@@ -3,6 +3,14 @@
 
 #include<chrono>
 
+#include<thread>
+
+#include<cmath>
+
+#include<atomic>
+
+#include"clock.h"	// the clock of the whole game engine
+
 
 namespace bb
 {
@@ -56,6 +64,27 @@ namespace bb
     
     **** the fps can be changed from anywhere in the loop also if needed.
 
+    pacing modes:-
+
+    by default put_delay() spins (busy waits) through the whole delay, it's the most
+    accurate way to wait but it keeps a cpu core 100% busy even at low fps.
+
+    set_pacing(FPS_CONTROL::HYBRID) makes put_delay() sleep through most of the delay
+    and spin only for the last small part of it. the OS wakes a sleeping thread later
+    than asked (say, 1ms sleep takes 1.08ms), so we measure how long each short sleep
+    actually takes and keep a running estimate (mean + deviation) of it, we sleep only
+    while the remaining delay is longer than this estimate, the rest is spinned away.
+    so, the frame timing stays almost as accurate as spinning while the cpu rests.
+
+    all the times are read from the engine clock (see clock.h), in its MANUAL mode put_delay()
+    doesn't wait at all, it fast-forwards the clock to the end of the frame instead.
+
+    cpu time saved (time spent sleeping) in the last call to put_delay() is loaded in
+    another public member saved, in seconds.
+
+    time left in the last frame before put_delay() started waiting is loaded in public
+    member slack, in seconds, it's negative if the iteration took longer than it should.
+
     !!!! note: if the system cannot provide the fps asked by the user due to
     limitations of the system where this class is used, the fps will not be
     stabilized so, set the fps according to the capability of your system
@@ -63,28 +92,92 @@ namespace bb
 
 class bb::FPS_CONTROL
 {
+    public:
+
+    // how put_delay() waits for the rest of the frame
+
+    enum PACING { SPIN, HYBRID };
+
+    private:
+
     std::chrono::duration<double> required_delay, actual_delay;
 
     std::chrono::time_point<std::chrono::steady_clock, std::chrono::duration<double>> clk_now, clk_previous;
 
+    std::atomic<PACING> pacing;	// atomic, GAME_LOOP::set_pacing() may change it while put_delay() runs on another thread
+
+    // running estimate of how long a short sleep actually takes (in seconds)
+
+    double sleep_mean, sleep_var;
+
+    /*
+        sleep through the delay (ending at deadline) in short naps, as long as the
+        remaining delay is longer than the estimated duration of a nap
+
+        each nap is measured to update the estimate, so it adapts to the overshoot
+        of the OS scheduler
+    */
+
+    void sleep_until(std::chrono::time_point<std::chrono::steady_clock, std::chrono::duration<double>> deadline)
+    {
+        constexpr double weight = 0.1;	// weight of the latest measurement in the estimate
+
+        for(auto clk_start = CLOCK.now(); std::chrono::duration<double>(deadline - clk_start).count() > sleep_mean + std::sqrt(sleep_var);)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            auto clk_end = CLOCK.now();
+
+            double nap = std::chrono::duration<double>(clk_end - clk_start).count();
+
+            saved += nap;
+
+            // exponentially weighted mean and variance of the nap duration
+
+            double diff = nap - sleep_mean;
+
+            sleep_mean += weight * diff;
+
+            sleep_var = (1 - weight) * (sleep_var + weight * diff * diff);
+
+            clk_start = clk_end;
+        }
+    }
+
     public:
 
     double dt;
 
-    FPS_CONTROL()
+    double saved;	// cpu time saved (slept) in the last put_delay() in seconds
+
+    double slack;	// time left in the last iteration before put_delay() started waiting in seconds
+
+    FPS_CONTROL() : pacing(SPIN), sleep_mean(0.002), sleep_var(0), saved(0), slack(0)
     {
         set(20);
         
         initialize();
     }
 
-    explicit FPS_CONTROL(double target_fps)
+    explicit FPS_CONTROL(double target_fps) : pacing(SPIN), sleep_mean(0.002), sleep_var(0), saved(0), slack(0)
     {
         set(target_fps);
         
         initialize();
     }
 
+    // select how put_delay() waits, SPIN (default) or HYBRID
+
+    void set_pacing(PACING mode)
+    {
+        pacing.store(mode, std::memory_order_relaxed);
+    }
+
+    PACING get_pacing() const
+    {
+        return pacing.load(std::memory_order_relaxed);
+    }
+
     // set the fps
 
     void set(double target_fps)
@@ -99,11 +192,18 @@ class bb::FPS_CONTROL
         required_delay = std::chrono::duration<double>{interval_sec};
     }
 
+    // get the delay between 2 frames in seconds
+
+    double get_interval() const
+    {
+        return required_delay.count();
+    }
+
     // initialize dt and fps and time count system
 
     void initialize()
     {
-        clk_previous = std::chrono::steady_clock::now();
+        clk_previous = CLOCK.now();
 
         dt = 0;
     }
@@ -134,7 +234,7 @@ class bb::FPS_CONTROL
     {
         // adjusting suitable delay as per actual_delay & required_delay
 
-        clk_now = std::chrono::steady_clock::now();
+        clk_now = CLOCK.now();
 
         /*
             time taken to print = (clk_now - clk_previous)
@@ -144,11 +244,27 @@ class bb::FPS_CONTROL
 
         actual_delay = (required_delay - (clk_now - clk_previous));	// in seconds
 
-        for(clk_now = std::chrono::steady_clock::now(); (std::chrono::steady_clock::now() - clk_now) < actual_delay;);    // implementing actual delay
+        slack = actual_delay.count();
+
+        saved = 0;
+
+        if(!CLOCK.fast_forward(clk_now + actual_delay))
+        {
+            if(pacing.load(std::memory_order_relaxed) == HYBRID)
+            {
+                // sleep through most of the delay, the rest is spinned away below
+
+                sleep_until(clk_now + actual_delay);
+
+                actual_delay -= CLOCK.now() - clk_now;
+            }
+
+            for(clk_now = CLOCK.now(); (CLOCK.now() - clk_now) < actual_delay;);    // implementing actual delay
+        }
 
         // calculating actual elapsed time in an iteration
 
-        clk_now = std::chrono::steady_clock::now();
+        clk_now = CLOCK.now();
 
         actual_delay = clk_now - clk_previous;
 
@@ -0,0 +1,192 @@
+#pragma once
+
+#include<array>
+
+#include<atomic>
+
+#include<algorithm>
+
+#include<cmath>
+
+
+namespace bb
+{
+	template<size_t CAPACITY = 1024>
+
+	class FRAME_STATS;
+}
+
+
+/*
+	this class stores per-frame timing samples of a game loop in a fixed size ring
+	buffer and reports percentiles over the last few frames, so we can find hitches
+	(those few slow frames that ruin the smoothness) without attaching a profiler
+
+	each sample holds these fields (all times are in seconds),
+
+	FRAME_TIME   -> time between two frames
+	RENDER_TIME  -> time taken by Clear(), Render() and Print()
+	RENDER_WAIT  -> time the render loop waited for the update loop
+	UPDATE_TIME  -> time taken by all the Input() - Update() calls of this frame
+	UPDATE_TICKS -> no. of Update() calls in this frame
+	UPDATE_WAIT  -> time the update loop waited for the render loop
+	SLACK        -> time left in the frame before the frame pacer started waiting
+	                (negative if the frame took longer than it should)
+	LATENCY      -> time from the Input() shown by this frame to the end of its Print()
+
+	how it works:-
+
+	the ring holds the last CAPACITY samples (CAPACITY must be a power of 2), a new
+	sample overwrites the oldest one. only one thread (the producer) is allowed to
+	push() samples, any no. of threads can call report() at the same time.
+
+	no locks are used, every value is stored in an atomic variable and the producer
+	publishes a sample by incrementing "head" after writing it, so push() never waits
+	and costs only a few stores.
+
+	!!!! if the report window covers the whole ring, the oldest sample may get overwritten
+	!!!! while report() reads it, so the report may contain one sample of the next frame,
+	!!!! it's harmless for statistics
+
+	how to use:-
+
+	FRAME_STATS<> stats;	// 1024 samples
+
+	FRAME_STATS<>::SAMPLE sample{};
+
+	sample[FRAME_STATS<>::FRAME_TIME] = dt;
+
+	...
+
+	stats.push(sample);	// once in each frame
+
+	// p50, p95, p99 and max of the frame time over last 300 frames, frames longer than
+	// 1 / 20 seconds are counted as hitches
+
+	auto report = stats.report(FRAME_STATS<>::FRAME_TIME, 300, 1.0 / 20);
+*/
+
+template<size_t CAPACITY>
+
+class bb::FRAME_STATS
+{
+	static_assert(
+
+		CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+
+		"!!!! CAPACITY of FRAME_STATS must be a power of 2 !!!!"
+	);
+
+
+	public:
+
+
+	enum FIELD { FRAME_TIME, RENDER_TIME, RENDER_WAIT, UPDATE_TIME, UPDATE_TICKS, UPDATE_WAIT, SLACK, LATENCY, FIELD_COUNT };
+
+	using SAMPLE = std::array<double, FIELD_COUNT>;
+
+	struct REPORT
+	{
+		double p50, p95, p99, max;
+
+		size_t hitches;	// no. of samples > hitch limit
+
+		size_t frames;	// no. of samples in the report
+	};
+
+
+	private:
+
+
+	std::array<std::array<std::atomic<double>, FIELD_COUNT>, CAPACITY> ring;
+
+	std::atomic<size_t> head;	// total no. of samples pushed so far
+
+
+	public:
+
+
+	FRAME_STATS() : head(0)
+	{}
+
+
+	// store a new sample, call it only from one thread
+
+	void push(const SAMPLE &sample) noexcept
+	{
+		size_t index = head.load(std::memory_order_relaxed);
+
+		auto &slot = ring[index & (CAPACITY - 1)];
+
+		for(size_t i = 0; i < FIELD_COUNT; i++)
+		{
+			slot[i].store(sample[i], std::memory_order_relaxed);
+		}
+
+		head.store(index + 1, std::memory_order_release);	// publish the sample
+	}
+
+
+	// no. of samples available for a report
+
+	size_t count() const noexcept
+	{
+		return std::min(head.load(std::memory_order_acquire), CAPACITY);
+	}
+
+
+	// forget all the samples, don't call it while the producer is running
+
+	void clear() noexcept
+	{
+		head = 0;
+	}
+
+
+	/*
+		percentiles (nearest rank), max and no. of hitches of a field over the last
+		"window" samples (clamped to the available samples)
+
+		all values are 0 if there are no samples
+	*/
+
+	REPORT report(FIELD field, size_t window, double hitch_limit) const noexcept
+	{
+		std::array<double, CAPACITY> value;
+
+		size_t end = head.load(std::memory_order_acquire);
+
+		size_t frames = std::min({window, end, CAPACITY});
+
+		REPORT result{0, 0, 0, 0, 0, frames};
+
+		if(frames == 0)
+		{
+			return result;
+		}
+
+		for(size_t i = 0; i < frames; i++)
+		{
+			value[i] = ring[(end - frames + i) & (CAPACITY - 1)][field].load(std::memory_order_relaxed);
+
+			if(value[i] > hitch_limit)
+			{
+				result.hitches++;
+			}
+		}
+
+		std::sort(value.begin(), value.begin() + frames);
+
+		auto rank = [&](double percent) { return value[(size_t)std::ceil(percent * frames) - 1]; };
+
+		result.p50 = rank(0.50);
+
+		result.p95 = rank(0.95);
+
+		result.p99 = rank(0.99);
+
+		result.max = value[frames - 1];
+
+		return result;
+	}
+};
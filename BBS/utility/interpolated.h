@@ -0,0 +1,140 @@
+#pragma once
+
+#include<cstddef>
+
+
+namespace bb
+{
+	template<typename T>
+
+	struct INTERPOLATED;
+
+	template<typename T>
+
+	T lerp(const T &a, const T &b, double alpha) noexcept;
+
+	template<typename CONTAINER>
+
+	void store_all(CONTAINER &container, size_t count) noexcept;
+}
+
+
+/*
+	the update loop runs at a fixed rate (ups) and the render loop runs at a different rate
+	(fps), so a frame usually falls somewhere in between two updates, if we render the state
+	of the last update, the motion looks jerky (temporal aliasing), specially when ups is low.
+
+	GAME_LOOP::get_alpha() tells where the frame falls between the last two updates [0 - 1],
+	INTERPOLATED<T> keeps the last two states of a value, so that the render can draw the value
+	interpolated between them.
+
+	how to use:-
+
+	INTERPOLATED<sf::Vector2f> position;
+
+	// in Update(), at the start of each update store the current state as previous state
+
+	position.store();
+
+	position.current += velocity * dt;	// modify only the current state
+
+	// or simply,
+
+	position.set(position.current + velocity * dt);	// store() + modify
+
+	// in Render(), draw the interpolated state
+
+	sprite.setPosition(position.get(MY_GAME.get_alpha()));
+
+	// to jump to a new position without interpolating (say, teleport), use reset()
+
+	position.reset({0, 0});
+
+	with ECS:-
+
+	INTERPOLATED<T> can be used as a component type, call store_all() at the start of each
+	update to store the states of all the entities at once,
+
+	ECS<INTERPOLATED<sf::Vector2f>, sf::Vector2f>::C8 ecs;
+
+	store_all(ecs.component<POSITION>(), ecs.entity_count());
+
+	T must support T + T, T - T and T * double (or T * float, like sf::Vector2f)
+*/
+
+template<typename T>
+
+struct bb::INTERPOLATED
+{
+	T previous, current;
+
+
+	INTERPOLATED(const T &value = T{}) : previous(value), current(value)
+	{}
+
+
+	// current state becomes the previous state
+
+	void store() noexcept
+	{
+		previous = current;
+	}
+
+
+	// store the current state and set a new one
+
+	void set(const T &value) noexcept
+	{
+		previous = current;
+
+		current = value;
+	}
+
+
+	// set both the states, so that there is nothing to interpolate
+
+	void reset(const T &value) noexcept
+	{
+		previous = current = value;
+	}
+
+
+	// state interpolated between previous (alpha = 0) and current (alpha = 1)
+
+	T get(double alpha) const noexcept
+	{
+		return bb::lerp(previous, current, alpha);
+	}
+};
+
+
+// linear interpolation between a (alpha = 0) and b (alpha = 1)
+
+template<typename T>
+
+inline T bb::lerp(const T &a, const T &b, double alpha) noexcept
+{
+	if constexpr (requires { a + (b - a) * alpha; })
+	{
+		return static_cast<T>(a + (b - a) * alpha);
+	}
+	else
+	{
+		// types like sf::Vector2f can only be multiplied with float
+
+		return a + (b - a) * static_cast<float>(alpha);
+	}
+}
+
+
+// store() the first "count" INTERPOLATED<T> objects of a container (say, an ECS component vector)
+
+template<typename CONTAINER>
+
+inline void bb::store_all(CONTAINER &container, size_t count) noexcept
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		container[i].store();
+	}
+}
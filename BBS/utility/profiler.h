@@ -0,0 +1,301 @@
+#pragma once
+
+#include<chrono>
+
+#include<atomic>
+
+#include<mutex>
+
+#include<vector>
+
+#include<memory>
+
+#include<string>
+
+#include<fstream>
+
+#include<cstdint>
+
+
+namespace bb
+{
+	class PROFILER_CLASS;
+
+	class PROFILE_TIMER;
+}
+
+
+/*
+	a tiny profiler, it records how long each scope (say, each Update() call) takes on each
+	thread and writes them in Chrome trace-event JSON format, open the file in chrome://tracing
+	or https://ui.perfetto.dev to see where the time of each frame goes.
+
+	it's disabled by default, define "ENABLE_PROFILER" macro before including any header of the
+	engine to enable it, when disabled the macros below expand to nothing, so there is no cost at all.
+
+	GAME_LOOP already profiles every call to Create(), Input(), Input_Sync(), Update(),
+	Render_Thread_Init(), Clear(), Render(), Print() and Destroy(), and game.h writes the trace
+	when the game ends (see game.h).
+
+	how to use:-
+
+	PROFILE_SCOPE("physics");	// records the time from here to the end of the enclosing scope
+
+	PROFILE_THREAD("audio");	// name of the current thread in the trace
+
+	PROFILER.write_trace("trace.json");	// write all the recorded scopes
+
+	**********************************
+	Let me describe it's inner working
+	**********************************
+
+	each thread records in its own buffer, so recording never locks and never waits for the
+	other threads. the buffer of a thread is created (under a lock) by its first record, it
+	belongs to PROFILER, so it outlives the thread and can be written after the thread ends.
+
+	a buffer is a ring of fixed size, it keeps only the latest EVENTS_PER_THREAD records, so a
+	long running game never runs out of memory, the trace shows its last few seconds.
+
+	a record is just a name (a string literal, not copied) and two steady_clock time stamps,
+	so a PROFILE_SCOPE costs two clock reads and a few stores.
+
+	!!!! the names must be string literals (or strings that live till the trace is written)
+
+	!!!! write_trace() reads the buffers of all the threads, call it when the profiled threads
+	!!!! are not recording (say, after the game loop ends), else some records may be torn
+*/
+
+class bb::PROFILER_CLASS
+{
+	public:
+
+
+	static constexpr size_t EVENTS_PER_THREAD = 1 << 15;	// must be a power of 2
+
+
+	private:
+
+
+	struct EVENT
+	{
+		const char *name;
+
+		int64_t start, end;	// in nanoseconds since the profiler was created
+	};
+
+
+	struct BUFFER
+	{
+		std::vector<EVENT> events;
+
+		size_t count = 0;	// total no. of events recorded, the ring holds the last EVENTS_PER_THREAD
+
+		size_t id;	// thread id in the trace
+
+		std::string thread_name;
+	};
+
+
+	std::chrono::steady_clock::time_point epoch;
+
+	std::mutex lock;	// to create the buffers
+
+	std::vector<std::unique_ptr<BUFFER>> buffers;
+
+	inline static thread_local BUFFER *current = nullptr;
+
+
+	BUFFER& buffer()
+	{
+		if(!current)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+
+			auto &created = buffers.emplace_back(std::make_unique<BUFFER>());
+
+			created->events.resize(EVENTS_PER_THREAD);
+
+			created->id = buffers.size();
+
+			created->thread_name = "thread " + std::to_string(created->id);
+
+			current = created.get();
+		}
+
+		return *current;
+	}
+
+
+	// to write the names in json strings
+
+	static void write_string(std::ofstream &file, const char *text)
+	{
+		file << '"';
+
+		for(; *text; text++)
+		{
+			if(*text == '"' || *text == '\\')
+			{
+				file << '\\';
+			}
+
+			file << *text;
+		}
+
+		file << '"';
+	}
+
+
+	public:
+
+
+	PROFILER_CLASS() : epoch(std::chrono::steady_clock::now())
+	{}
+
+
+	int64_t now() const noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+	}
+
+
+	// record a scope of the current thread
+
+	void record(const char *name, int64_t start, int64_t end)
+	{
+		BUFFER &current_buffer = buffer();
+
+		current_buffer.events[current_buffer.count & (EVENTS_PER_THREAD - 1)] = {name, start, end};
+
+		current_buffer.count++;
+	}
+
+
+	// name the current thread in the trace
+
+	void name_thread(const char *name)
+	{
+		buffer().thread_name = name;
+	}
+
+
+	// forget all the records (buffers of the threads are kept)
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		for(auto &each : buffers)
+		{
+			each->count = 0;
+		}
+	}
+
+
+	// write the records of all the threads in Chrome trace-event JSON format, returns false if the file can't be written
+
+	bool write_trace(const std::string &path)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		std::ofstream file(path);
+
+		if(!file)
+		{
+			return false;
+		}
+
+		file << "{\"traceEvents\":[\n";
+
+		bool first = true;
+
+		for(auto &each : buffers)
+		{
+			// thread name
+
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << each->id << ",\"args\":{\"name\":";
+
+			write_string(file, each->thread_name.c_str());
+
+			file << "}}";
+
+			first = false;
+
+			// the oldest record in the ring first
+
+			size_t begin = (each->count > EVENTS_PER_THREAD) ? each->count - EVENTS_PER_THREAD : 0;
+
+			for(size_t i = begin; i < each->count; i++)
+			{
+				const EVENT &event = each->events[i & (EVENTS_PER_THREAD - 1)];
+
+				// complete event, times in microseconds
+
+				file << ",\n{\"name\":";
+
+				write_string(file, event.name);
+
+				file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << each->id
+					<< ",\"ts\":" << event.start / 1000 << '.' << event.start % 1000 / 100
+					<< ",\"dur\":" << (event.end - event.start) / 1000 << '.' << (event.end - event.start) % 1000 / 100 << '}';
+			}
+		}
+
+		file << "\n]}\n";
+
+		return (bool)file;
+	}
+};
+
+
+namespace bb
+{
+	inline PROFILER_CLASS PROFILER;	// the profiler of the whole game engine
+}
+
+
+// records the time from its creation to its destruction (use PROFILE_SCOPE macro instead)
+
+class bb::PROFILE_TIMER
+{
+	const char *name;
+
+	int64_t start;
+
+
+	public:
+
+
+	explicit PROFILE_TIMER(const char *name_in) noexcept : name(name_in), start(PROFILER.now())
+	{}
+
+
+	~PROFILE_TIMER()
+	{
+		PROFILER.record(name, start, PROFILER.now());
+	}
+
+
+	PROFILE_TIMER(const PROFILE_TIMER&) = delete;
+
+	PROFILE_TIMER& operator=(const PROFILE_TIMER&) = delete;
+};
+
+
+#define BB_PROFILE_CONCAT_(a, b) a##b
+
+#define BB_PROFILE_CONCAT(a, b) BB_PROFILE_CONCAT_(a, b)
+
+#ifdef ENABLE_PROFILER
+
+	#define PROFILE_SCOPE(name) bb::PROFILE_TIMER BB_PROFILE_CONCAT(profile_timer_, __LINE__)(name)
+
+	#define PROFILE_THREAD(name) bb::PROFILER.name_thread(name)
+
+#else
+
+	#define PROFILE_SCOPE(name) ((void)0)
+
+	#define PROFILE_THREAD(name) ((void)0)
+
+#endif
@@ -0,0 +1,176 @@
+#pragma once
+
+#include<array>
+
+#include<atomic>
+
+#include<cstdint>
+
+
+namespace bb
+{
+	template<typename T, size_t CAPACITY>
+
+	class SPSC_QUEUE;
+}
+
+
+/*
+	a bounded lock free queue for one producer thread and one consumer thread
+
+	the elements live in a fixed array and are reused, the producer fills the element at
+	the back in place and pushes it, the consumer reads the element at the front in place
+	and pops it, so nothing is allocated or copied (an element holding a vector keeps its
+	capacity from one use to the next).
+
+	how to use:-
+
+	SPSC_QUEUE<std::vector<int>, 4> queue;
+
+	// producer
+
+	if(auto element = queue.back())	// nullptr if the queue is full
+	{
+		element->clear();
+
+		element->push_back(10);
+
+		queue.push();
+	}
+
+	// consumer
+
+	if(auto element = queue.front())	// nullptr if the queue is empty
+	{
+		use(*element);
+
+		queue.pop();
+	}
+
+	waiting:-
+
+	to wait for the queue to change (without spinning), read version() first, check the queue and
+	if it's full (or empty) call wait(version), it returns after the next push(), pop() or interrupt(),
+	interrupt() is used to wake up a waiting thread that has to stop.
+
+	auto version = queue.version();
+
+	if(!queue.front())
+	{
+		queue.wait(version);
+	}
+*/
+
+template<typename T, size_t CAPACITY>
+
+class bb::SPSC_QUEUE
+{
+	static_assert(
+
+		CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+
+		"!!!! CAPACITY of SPSC_QUEUE must be a power of 2 !!!!"
+	);
+
+
+	std::array<T, CAPACITY> element;
+
+	std::atomic<size_t> head, tail;	// total no. of pops and pushes
+
+	std::atomic<uint32_t> signal;	// changes on each push, pop and interrupt
+
+
+	void notify() noexcept
+	{
+		signal.fetch_add(1, std::memory_order_release);
+
+		signal.notify_all();
+	}
+
+
+	public:
+
+
+	SPSC_QUEUE() : head(0), tail(0), signal(0)
+	{}
+
+
+	// element to be filled by the producer, nullptr if the queue is full
+
+	T* back() noexcept
+	{
+		size_t index = tail.load(std::memory_order_relaxed);
+
+		if(index - head.load(std::memory_order_acquire) == CAPACITY)
+		{
+			return nullptr;
+		}
+
+		return &element[index & (CAPACITY - 1)];
+	}
+
+
+	// push the element filled at back()
+
+	void push() noexcept
+	{
+		tail.fetch_add(1, std::memory_order_release);
+
+		notify();
+	}
+
+
+	// element to be read by the consumer, nullptr if the queue is empty
+
+	T* front() noexcept
+	{
+		size_t index = head.load(std::memory_order_relaxed);
+
+		if(index == tail.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+
+		return &element[index & (CAPACITY - 1)];
+	}
+
+
+	// pop the element read at front()
+
+	void pop() noexcept
+	{
+		head.fetch_add(1, std::memory_order_release);
+
+		notify();
+	}
+
+
+	uint32_t version() const noexcept
+	{
+		return signal.load(std::memory_order_acquire);
+	}
+
+
+	// wait till the queue changes after version() returned "seen"
+
+	void wait(uint32_t seen) const noexcept
+	{
+		signal.wait(seen, std::memory_order_acquire);
+	}
+
+
+	// wake up the waiting thread
+
+	void interrupt() noexcept
+	{
+		notify();
+	}
+
+
+	// remove all the elements, don't call it while the producer or consumer is running
+
+	void clear() noexcept
+	{
+		head = tail.load();
+	}
+};
@@ -0,0 +1,284 @@
+/*
+	benchmark of the easing functions (see BBS/timer/tween_accessories.h and BBS/timer/easing_batch.h)
+
+	it's a standalone program, it needs no SFML, build and run it on linux, from this folder,
+
+	g++ -std=c++20 -O3 -march=native -fno-math-errno -I.. easing_benchmark.cpp -o easing_benchmark
+
+	./easing_benchmark > easing.json	// results as JSON, progress on stderr
+
+	./easing_benchmark --count 100000 --repeat 5 --samples 4096
+
+	--count		no. of progress values eased at once, default 10000
+
+	--repeat	each test runs this many times, the best time is reported, default 20
+
+	--samples	no. of samples of the lookup tables, default 1024
+
+	for each of the 31 easing functions of TWN_TYPE,
+
+	function		TWN_TYPE::xxx called through a std::function, as TWEENER does, ns per value
+
+	scalar			TWN_TYPE::xxx called directly in a loop, ns per value
+
+	batch			TWN_BATCH::ease<TWN_TYPE::xxx>(), ns per value
+
+	lut				TWN_LUT::ease(), ns per value
+
+	batch_error		largest difference between batch and scalar
+
+	lut_error		largest difference between lut and scalar (the progress values are not the ones
+					the table is checked at), and the max_error() of the table
+*/
+
+#include"BBS/timer/easing_batch.h"
+
+#include<chrono>
+
+#include<algorithm>
+
+#include<random>
+
+#include<string>
+
+#include<vector>
+
+#include<cstdio>
+
+#include<cstdlib>
+
+#include<cstring>
+
+
+struct RESULT
+{
+	std::string name;
+
+	double function_ns, scalar_ns, batch_ns, lut_ns;
+
+	double batch_error, lut_error, lut_max_error;
+};
+
+
+std::vector<RESULT> results;
+
+size_t count = 10000, repeat = 20, samples = 1024;
+
+std::vector<double> progress, eased, expected;
+
+volatile double sink;	// keeps the loops from being optimized out
+
+
+// runs "test" repeat times, returns the best ns per value
+
+template<typename TEST>
+
+double measure(TEST &&test)
+{
+	double best = 1e300;
+
+	for(size_t i = 0; i < repeat; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		test();
+
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		best = std::min(best, ns / count);
+
+		sink = eased[i % count];
+	}
+
+	return best;
+}
+
+
+double max_difference()
+{
+	double error = 0;
+
+	for(size_t i = 0; i < count; i++)
+	{
+		error = std::max(error, std::abs(eased[i] - expected[i]));
+	}
+
+	return error;
+}
+
+
+template<double (*EASE)(double)>
+
+void run(const char *name)
+{
+	RESULT result;
+
+	result.name = name;
+
+	bb::TWN_TYPE::func function = EASE;
+
+	result.function_ns = measure([&]
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			eased[i] = function(progress[i]);
+		}
+	});
+
+	result.scalar_ns = measure([&]
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			eased[i] = EASE(progress[i]);
+		}
+	});
+
+	expected = eased;
+
+	result.batch_ns = measure([&]
+	{
+		bb::TWN_BATCH::ease<EASE>(progress.data(), eased.data(), count);
+	});
+
+	result.batch_error = max_difference();
+
+	bb::TWN_LUT lut(EASE, samples);
+
+	result.lut_ns = measure([&]
+	{
+		lut.ease(progress.data(), eased.data(), count);
+	});
+
+	result.lut_error = max_difference();
+
+	result.lut_max_error = lut.max_error();
+
+	results.push_back(result);
+
+	std::fprintf(
+		stderr, "%-16s function %6.2f scalar %6.2f batch %6.2f lut %6.2f ns   batch error %.1e lut error %.1e\n",
+		name, result.function_ns, result.scalar_ns, result.batch_ns, result.lut_ns, result.batch_error, result.lut_error
+	);
+}
+
+
+int main(int argc, char **argv)
+{
+	for(int i = 1; i + 1 < argc; i += 2)
+	{
+		if(!std::strcmp(argv[i], "--count"))
+		{
+			count = std::max(std::strtoull(argv[i + 1], nullptr, 10), 1ull);
+		}
+		else if(!std::strcmp(argv[i], "--repeat"))
+		{
+			repeat = std::max(std::strtoull(argv[i + 1], nullptr, 10), 1ull);
+		}
+		else if(!std::strcmp(argv[i], "--samples"))
+		{
+			samples = std::max(std::strtoull(argv[i + 1], nullptr, 10), 1ull);
+		}
+	}
+
+	// random progress values in [0, 1], with the ends, where some functions have special cases
+
+	std::mt19937_64 random(1);
+
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+	progress.resize(count);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		progress[i] = uniform(random);
+	}
+
+	progress[0] = 0.0;
+
+	progress[count - 1] = 1.0;
+
+	eased.resize(count);
+
+	using bb::TWN_TYPE;
+
+	run<TWN_TYPE::linear>("linear");
+
+	run<TWN_TYPE::in_sine>("in_sine");
+
+	run<TWN_TYPE::out_sine>("out_sine");
+
+	run<TWN_TYPE::in_out_sine>("in_out_sine");
+
+	run<TWN_TYPE::in_quad>("in_quad");
+
+	run<TWN_TYPE::out_quad>("out_quad");
+
+	run<TWN_TYPE::in_out_quad>("in_out_quad");
+
+	run<TWN_TYPE::in_cubic>("in_cubic");
+
+	run<TWN_TYPE::out_cubic>("out_cubic");
+
+	run<TWN_TYPE::in_out_cubic>("in_out_cubic");
+
+	run<TWN_TYPE::in_quart>("in_quart");
+
+	run<TWN_TYPE::out_quart>("out_quart");
+
+	run<TWN_TYPE::in_out_quart>("in_out_quart");
+
+	run<TWN_TYPE::in_quint>("in_quint");
+
+	run<TWN_TYPE::out_quint>("out_quint");
+
+	run<TWN_TYPE::in_out_quint>("in_out_quint");
+
+	run<TWN_TYPE::in_expo>("in_expo");
+
+	run<TWN_TYPE::out_expo>("out_expo");
+
+	run<TWN_TYPE::in_out_expo>("in_out_expo");
+
+	run<TWN_TYPE::in_circ>("in_circ");
+
+	run<TWN_TYPE::out_circ>("out_circ");
+
+	run<TWN_TYPE::in_out_circ>("in_out_circ");
+
+	run<TWN_TYPE::in_back>("in_back");
+
+	run<TWN_TYPE::out_back>("out_back");
+
+	run<TWN_TYPE::in_out_back>("in_out_back");
+
+	run<TWN_TYPE::in_elastic>("in_elastic");
+
+	run<TWN_TYPE::out_elastic>("out_elastic");
+
+	run<TWN_TYPE::in_out_elastic>("in_out_elastic");
+
+	run<TWN_TYPE::in_bounce>("in_bounce");
+
+	run<TWN_TYPE::out_bounce>("out_bounce");
+
+	run<TWN_TYPE::in_out_bounce>("in_out_bounce");
+
+	// JSON on stdout
+
+	std::printf("{\n\"benchmark\": \"easing\",\n\"count\": %zu,\n\"repeat\": %zu,\n\"samples\": %zu,\n\"results\": [\n", count, repeat, samples);
+
+	for(size_t i = 0; i < results.size(); i++)
+	{
+		const RESULT &result = results[i];
+
+		std::printf(
+			"{\"ease\": \"%s\", \"function_ns\": %.3f, \"scalar_ns\": %.3f, \"batch_ns\": %.3f, \"lut_ns\": %.3f, \"batch_error\": %.3e, \"lut_error\": %.3e, \"lut_max_error\": %.3e}%s\n",
+			result.name.c_str(), result.function_ns, result.scalar_ns, result.batch_ns, result.lut_ns,
+			result.batch_error, result.lut_error, result.lut_max_error, i + 1 < results.size() ? "," : ""
+		);
+	}
+
+	std::printf("]\n}\n");
+
+	return 0;
+}
@@ -0,0 +1,435 @@
+/*
+	benchmark of ENTITY_COMPONENT_SYSTEM (see BBS/entity_component_system/entity_component_system.h)
+
+	it's a standalone program, it needs no SFML, build and run it on linux, from this folder,
+
+	g++ -std=c++20 -O2 -march=native -I.. ecs_benchmark.cpp -o ecs_benchmark -pthread
+
+	./ecs_benchmark > ecs.json	// results as JSON, progress on stderr
+
+	./ecs_benchmark --max 10000000 --repeat 5 --max-bytes 4000000000
+
+	--max		largest no. of entities (1k, 10k, 100k ... up to this), default 1000000
+
+	--repeat	each test runs this many times on a new ECS, the best time is reported, default 3
+
+	--max-bytes	the (no. of entities, no. of components) pairs that need more memory are skipped, default 1 GB
+
+	the tests run for 1, 8, 16, 32 and 64 float components (C8, C8, C16, C32 and C64 bitmasks),
+
+	create_grow		create_entity() from an empty ECS, grows with reserve_extra(), per entity
+
+	create_reserved		create_entity() after reserve_extra(n), per entity
+
+	iterate			each<0>() over all the entities, per entity
+
+	query			each<0, last>(), the last component removed from every other entity, per entity scanned
+
+	view			for(id : view<0, last>()) over the same entities, per entity scanned
+
+	kill_swap		kill_entity() of 10% of the entities, picked at random (each once), one by one, per kill
+
+	kill_batch		the same entities killed through a COMMAND_BUFFER and flushed, per kill
+
+	churn			10 frames of killing 1% random entities and creating as many, per kill or create
+
+	each result also has the no. of vector reallocations done by create_grow and the bytes used
+	by the ECS, compare the JSON of two builds to catch a regression in the hot paths.
+*/
+
+#include"BBS/entity_component_system/entity_component_system.h"
+
+#include<chrono>
+
+#include<memory>
+
+#include<algorithm>
+
+#include<numeric>
+
+#include<random>
+
+#include<string>
+
+#include<vector>
+
+#include<cstdio>
+
+#include<cstdlib>
+
+#include<cstring>
+
+#include<utility>
+
+
+// ECS with K float components and MASK type bitmasks
+
+template<size_t index>
+
+using FLOAT = float;
+
+template<typename MASK, typename SEQUENCE>
+
+struct MAKE_ECS;
+
+template<typename MASK, size_t... index>
+
+struct MAKE_ECS<MASK, std::index_sequence<index...>>
+{
+	using type = bb::ENTITY_COMPONENT_SYSTEM<MASK, 100, FLOAT<index>...>;
+};
+
+template<typename MASK, size_t K>
+
+using BENCH_ECS = typename MAKE_ECS<MASK, std::make_index_sequence<K>>::type;
+
+
+
+struct RESULT
+{
+	size_t entities, components, mask_bits;
+
+	std::string test;
+
+	double ns_per_op;
+
+	size_t ops = 0;
+
+	size_t reallocations, bytes;
+};
+
+
+std::vector<RESULT> results;
+
+size_t repeat = 3;
+
+volatile double sink;	// keeps the loops from being optimized out
+
+
+// runs "test" (which returns the no. of operations it did) repeat times, returns the best ns per operation
+
+template<typename SETUP, typename TEST>
+
+double measure(SETUP &&setup, TEST &&test, size_t &ops)
+{
+	double best = 1e300;
+
+	for(size_t i = 0; i < repeat; i++)
+	{
+		auto state = setup();
+
+		auto start = std::chrono::steady_clock::now();
+
+		ops = test(*state);
+
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		if(ops)
+		{
+			best = std::min(best, ns / ops);
+		}
+	}
+
+	return best;
+}
+
+
+template<typename MASK, size_t K>
+
+void run(size_t count)
+{
+	using ECS_TYPE = BENCH_ECS<MASK, K>;
+
+	constexpr uint8_t LAST = K - 1;
+
+	size_t reallocations = 0, bytes = 0;
+
+	auto add = [&](const char *test, double ns, size_t ops)
+	{
+		results.push_back({count, K, sizeof(MASK) * 8, test, ns, ops, reallocations, bytes});
+
+		std::fprintf(stderr, "%9zu entities %2zu components %-16s %10.2f ns\n", count, K, test, ns);
+	};
+
+	// an empty ECS
+
+	auto empty = []
+	{
+		return std::make_unique<ECS_TYPE>();
+	};
+
+	// an ECS holding "count" entities, with all the components, the values are the ids
+
+	auto filled = [count]
+	{
+		auto ecs = std::make_unique<ECS_TYPE>();
+
+		ecs->reserve_extra(count);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			ecs->create_entity().template get<0>() = (float)i;
+		}
+
+		return ecs;
+	};
+
+	// same, but the last component is removed from every other entity
+
+	auto half = [count, &filled]
+	{
+		auto ecs = filled();
+
+		for(size_t i = 1; i < count; i += 2)
+		{
+			ecs->entity(i).template remove<LAST>();
+		}
+
+		return ecs;
+	};
+
+	size_t ops = 0;
+
+	double ns;
+
+	ns = measure(empty, [&](ECS_TYPE &ecs)
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			ecs.create_entity();
+		}
+
+		auto stats = ecs.memory_stats();
+
+		reallocations = stats.reallocations;
+
+		bytes = stats.bytes;
+
+		return count;
+	}, ops);
+
+	add("create_grow", ns, ops);
+
+	ns = measure(empty, [&](ECS_TYPE &ecs)
+	{
+		ecs.reserve_extra(count);
+
+		for(size_t i = 0; i < count; i++)
+		{
+			ecs.create_entity();
+		}
+
+		return count;
+	}, ops);
+
+	add("create_reserved", ns, ops);
+
+	ns = measure(filled, [&](ECS_TYPE &ecs)
+	{
+		double sum = 0;
+
+		ecs.template each<0>([&](float &value) { sum += value; });
+
+		sink = sum;
+
+		return ecs.entity_count();
+	}, ops);
+
+	add("iterate", ns, ops);
+
+	ns = measure(half, [&](ECS_TYPE &ecs)
+	{
+		double sum = 0;
+
+		ecs.template each<0, LAST>([&](float &value, float&) { sum += value; });
+
+		sink = sum;
+
+		return ecs.entity_count();
+	}, ops);
+
+	add("query", ns, ops);
+
+	ns = measure(half, [&](ECS_TYPE &ecs)
+	{
+		double sum = 0;
+
+		auto &values = ecs.template component<0>();
+
+		for(size_t id : ecs.template view<0, LAST>())
+		{
+			sum += values[id];
+		}
+
+		sink = sum;
+
+		return ecs.entity_count();
+	}, ops);
+
+	add("view", ns, ops);
+
+	/*
+		the victims, 10% of the entities, unique, picked before the timing starts, both kill tests
+		kill the same entities, through their handles, as the ids change while the entities die
+	*/
+
+	std::vector<size_t> victims(count);
+
+	std::iota(victims.begin(), victims.end(), (size_t)0);
+
+	std::shuffle(victims.begin(), victims.end(), std::mt19937_64(1));
+
+	victims.resize(count / 10);
+
+	auto filled_with_victims = [&filled, &victims]
+	{
+		auto ecs = filled();
+
+		std::vector<typename ECS_TYPE::HANDLE> handles;
+
+		for(size_t id : victims)
+		{
+			handles.push_back(ecs->handle(id));
+		}
+
+		return std::make_unique<std::pair<std::unique_ptr<ECS_TYPE>, std::vector<typename ECS_TYPE::HANDLE>>>(std::move(ecs), std::move(handles));
+	};
+
+	ns = measure(filled_with_victims, [&](auto &state)
+	{
+		ECS_TYPE &ecs = *state.first;
+
+		size_t before = ecs.entity_count();
+
+		for(auto handle : state.second)
+		{
+			ecs.kill_entity(handle);
+		}
+
+		return before - ecs.entity_count();	// no. of entities killed
+	}, ops);
+
+	add("kill_swap", ns, ops);
+
+	auto filled_with_kills = [&filled, &victims]
+	{
+		auto ecs = filled();
+
+		auto commands = std::make_unique<typename ECS_TYPE::COMMAND_BUFFER>();
+
+		for(size_t id : victims)
+		{
+			commands->kill(ecs->handle(id));
+		}
+
+		return std::make_unique<std::pair<std::unique_ptr<ECS_TYPE>, std::unique_ptr<typename ECS_TYPE::COMMAND_BUFFER>>>(std::move(ecs), std::move(commands));
+	};
+
+	ns = measure(filled_with_kills, [&](auto &state)
+	{
+		size_t before = state.first->entity_count();
+
+		state.second->flush(*state.first);
+
+		return before - state.first->entity_count();	// no. of entities killed
+	}, ops);
+
+	add("kill_batch", ns, ops);
+
+	ns = measure(filled, [&](ECS_TYPE &ecs)
+	{
+		std::mt19937_64 random(1);
+
+		size_t changes = std::max(count / 100, (size_t)1);
+
+		for(int frame = 0; frame < 10; frame++)
+		{
+			for(size_t i = 0; i < changes; i++)
+			{
+				ecs.kill_entity(ecs.entity(random() % ecs.entity_count()));
+			}
+
+			for(size_t i = 0; i < changes; i++)
+			{
+				ecs.create_entity().template get<0>() = (float)i;
+			}
+		}
+
+		return changes * 2 * 10;
+	}, ops);
+
+	add("churn", ns, ops);
+}
+
+
+template<typename MASK, size_t K>
+
+void run_all(size_t max_count, size_t max_bytes)
+{
+	// components, bitmask, handle slot and slot_of of each entity, doubled for the growth
+
+	constexpr size_t ENTITY_BYTES = (K * sizeof(float) + sizeof(MASK) + 12) * 2;
+
+	for(size_t count = 1000; count <= max_count; count *= 10)
+	{
+		if(count * ENTITY_BYTES > max_bytes)
+		{
+			std::fprintf(stderr, "%9zu entities %2zu components skipped (--max-bytes)\n", count, K);
+
+			continue;
+		}
+
+		run<MASK, K>(count);
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	size_t max_count = 1000000, max_bytes = 1000000000;
+
+	for(int i = 1; i + 1 < argc; i += 2)
+	{
+		if(!std::strcmp(argv[i], "--max"))
+		{
+			max_count = std::strtoull(argv[i + 1], nullptr, 10);
+		}
+		else if(!std::strcmp(argv[i], "--repeat"))
+		{
+			repeat = std::max(std::strtoull(argv[i + 1], nullptr, 10), 1ull);
+		}
+		else if(!std::strcmp(argv[i], "--max-bytes"))
+		{
+			max_bytes = std::strtoull(argv[i + 1], nullptr, 10);
+		}
+	}
+
+	run_all<uint8_t, 1>(max_count, max_bytes);
+
+	run_all<uint8_t, 8>(max_count, max_bytes);
+
+	run_all<uint16_t, 16>(max_count, max_bytes);
+
+	run_all<uint32_t, 32>(max_count, max_bytes);
+
+	run_all<uint64_t, 64>(max_count, max_bytes);
+
+	// JSON on stdout
+
+	std::printf("{\n\"benchmark\": \"ecs\",\n\"repeat\": %zu,\n\"results\": [\n", repeat);
+
+	for(size_t i = 0; i < results.size(); i++)
+	{
+		const RESULT &result = results[i];
+
+		std::printf(
+			"{\"entities\": %zu, \"components\": %zu, \"mask_bits\": %zu, \"test\": \"%s\", \"ns_per_op\": %.3f, \"ops\": %zu, \"reallocations\": %zu, \"bytes\": %zu}%s\n",
+			result.entities, result.components, result.mask_bits, result.test.c_str(), result.ns_per_op, result.ops,
+			result.reallocations, result.bytes, i + 1 < results.size() ? "," : ""
+		);
+	}
+
+	std::printf("]\n}\n");
+
+	return 0;
+}